@@ -0,0 +1,500 @@
+/********************************************************************
+ * File:        batchBlur.h
+ *
+ * Description: Batch 3x3 blur of many PGM files as a three-stage
+ *              load -> blur -> store pipeline connected by bounded queues.
+ *              Small images are blurred one per worker (across-image
+ *              parallelism); images above a pixel threshold take all blur
+ *              workers for a nested parallel loop (within-image
+ *              parallelism). Image buffers are recycled through a pool.
+ ********************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <omp.h>
+
+#include "imageBuffer.h"
+#include "simdBlur.h"
+#include "streamingBlur.h"
+
+// Fixed-capacity blocking queue. pop() returns false once the queue is closed and drained.
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+
+    void push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        notFull.wait(lock, [&] { return items.size() < capacity; });
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+    }
+
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        notEmpty.wait(lock, [&] { return !items.empty() || closed; });
+
+        if (items.empty())
+            return false;
+
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        closed = true;
+        notEmpty.notify_all();
+    }
+
+private:
+    size_t capacity;
+    bool closed = false;
+
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable notEmpty, notFull;
+};
+
+// One image travelling through the pipeline. Buffers keep their capacity between images.
+struct BatchImage
+{
+    std::string path;
+
+    ImageFileInfo info;
+
+    std::vector<unsigned char> file;  // Raw file bytes; reused for the output file
+    ImageBuffer<uint8_t> in8, out8;
+    ImageBuffer<uint16_t> in16, out16;
+
+    bool loaded = false;
+};
+
+// Recycles BatchImage buffers so steady-state batches do not allocate.
+class BatchImagePool
+{
+public:
+    std::unique_ptr<BatchImage> acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (free.empty())
+        {
+            allocated++;
+
+            return std::unique_ptr<BatchImage>(new BatchImage());
+        }
+
+        reused++;
+
+        std::unique_ptr<BatchImage> image = std::move(free.back());
+
+        free.pop_back();
+
+        return image;
+    }
+
+    void release(std::unique_ptr<BatchImage> image)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        free.push_back(std::move(image));
+    }
+
+    long allocated = 0;
+    long reused = 0;
+
+private:
+    std::vector<std::unique_ptr<BatchImage>> free;
+    std::mutex mutex;
+};
+
+struct BatchOptions
+{
+    std::string source;     // Directory of .pgm files, or a text file listing one path per line
+    std::string outputDir;
+
+    int workers = 0;        // Blur workers (0: all threads but the loader and the storer)
+
+    long largeImagePixels = 1L << 20;  // At or above this size an image is blurred with all workers
+
+    size_t queueCapacity = 8;
+
+    SimdLevel isa = SimdLevel::Scalar;
+};
+
+struct BatchStats
+{
+    long images = 0;
+    long failed = 0;
+    long largeImages = 0;
+    long allocated = 0;
+    long reused = 0;
+    int workers = 0;
+
+    double pixels = 0.0;
+    double seconds = 0.0;
+
+    // Busy time per stage; the blur figure is summed over all workers
+    double loadBusy = 0.0;
+    double blurBusy = 0.0;
+    double storeBusy = 0.0;
+};
+
+inline std::string batchBaseName(const std::string& path)
+{
+    size_t slash = path.find_last_of('/');
+
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// Expanding the batch source into a list of input paths. Outputs are named after the inputs' base names,
+// so a list with two inputs of the same base name is rejected rather than having one overwrite the other.
+inline bool listBatchInputs(const std::string& source, std::vector<std::string>& paths, std::string& error)
+{
+    struct stat st;
+
+    if (stat(source.c_str(), &st) != 0)
+    {
+        error = "cannot list " + source;
+
+        return false;
+    }
+
+    if (S_ISDIR(st.st_mode))
+    {
+        DIR* dir = opendir(source.c_str());
+
+        if (!dir)
+        {
+            error = "cannot list " + source;
+
+            return false;
+        }
+
+        while (struct dirent* entry = readdir(dir))
+        {
+            std::string name = entry->d_name;
+
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".pgm") == 0)
+                paths.push_back(source + "/" + name);
+        }
+
+        closedir(dir);
+    }
+    else
+    {
+        std::ifstream list(source);
+        std::string line;
+
+        while (std::getline(list, line))
+        {
+            if (!line.empty() && line[0] != '#')
+                paths.push_back(line);
+        }
+    }
+
+    std::unordered_map<std::string, std::string> byName;
+
+    for (const std::string& path : paths)
+    {
+        auto entry = byName.emplace(batchBaseName(path), path);
+
+        if (!entry.second)
+        {
+            error = entry.first->second + " and " + path + " would both be written as " + entry.first->first;
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Load stage: reading the whole file and unpacking the samples into the pooled buffers.
+inline bool loadBatchImage(BatchImage& image)
+{
+    std::ifstream in(image.path, std::ios::binary);
+
+    if (!in)
+        return false;
+
+    image.file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    if (!parsePgmHeader(image.file.data(), image.file.size(), image.info))
+        return false;
+
+    const ImageFileInfo& info = image.info;
+    const size_t rowBytes = (size_t)info.width * info.bytesPerPixel;
+
+    if (info.dataOffset + rowBytes * info.height > image.file.size())
+        return false;
+
+    const unsigned char* pixels = image.file.data() + info.dataOffset;
+
+    if (info.bytesPerPixel == 1)
+    {
+        image.in8.reshape(info.height, info.width);
+        image.out8.reshape(info.height, info.width);
+
+        for (int i = 0; i < info.height; i++)
+            memcpy(image.in8.row(i), pixels + i * rowBytes, rowBytes);
+    }
+    else
+    {
+        image.in16.reshape(info.height, info.width);
+        image.out16.reshape(info.height, info.width);
+
+        for (int i = 0; i < info.height; i++)
+            loadSamples16(pixels + i * rowBytes, image.in16.row(i), info.width, info.bigEndian);
+    }
+
+    return true;
+}
+
+// Blur stage body for one image, either on the calling worker alone or on a nested team.
+inline void blurBatchImage(BatchImage& image, int teamSize, SimdLevel isa)
+{
+    if (teamSize > 1)
+    {
+        // Sets the team size of the nested parallel loop started from this worker only
+        omp_set_num_threads(teamSize);
+
+        if (image.info.bytesPerPixel == 1)
+            boxBlurSimdParallel(image.in8, image.out8, isa);
+        else
+            boxBlurSimdParallel(image.in16, image.out16, isa);
+    }
+    else if (image.info.bytesPerPixel == 1)
+        boxBlurSimdSequential(image.in8, image.out8, isa);
+    else
+        boxBlurSimdSequential(image.in16, image.out16, isa);
+}
+
+// Store stage: packing the result back over the pixel area of the original file bytes and writing it out.
+inline bool storeBatchImage(BatchImage& image, const std::string& outputDir)
+{
+    const ImageFileInfo& info = image.info;
+    const size_t rowBytes = (size_t)info.width * info.bytesPerPixel;
+
+    unsigned char* pixels = image.file.data() + info.dataOffset;
+
+    for (int i = 0; i < info.height; i++)
+    {
+        if (info.bytesPerPixel == 1)
+            memcpy(pixels + i * rowBytes, image.out8.row(i), rowBytes);
+        else
+            storeSamples16(image.out16.row(i), pixels + i * rowBytes, info.width, info.bigEndian);
+    }
+
+    std::ofstream out(outputDir + "/" + batchBaseName(image.path), std::ios::binary);
+
+    out.write((const char*)image.file.data(), (std::streamsize)(info.dataOffset + rowBytes * info.height));
+
+    return (bool)out;
+}
+
+// Busy time of one stage thread, on its own cache line.
+struct alignas(64) StageBusy
+{
+    double seconds = 0.0;
+};
+
+// Running the whole batch. Returns false (with error set) only if the source cannot be listed. The stages are assigned from
+// the team actually granted: loader, storer and the rest as blur workers, or all three stages one image after
+// another on a single thread if the team is smaller than three.
+inline bool batchBlur(const BatchOptions& options, BatchStats& stats, std::string& error)
+{
+    std::vector<std::string> paths;
+
+    if (!listBatchInputs(options.source, paths, error))
+        return false;
+
+    const int workers = options.workers > 0 ? options.workers : std::max(1, omp_get_max_threads() - 2);
+
+    BoundedQueue<std::unique_ptr<BatchImage>> toBlur(options.queueCapacity), toStore(options.queueCapacity);
+    BatchImagePool pool;
+
+    // Small images share this lock; a large image takes it exclusively so its nested team gets the cores.
+    std::shared_mutex coreLock;
+
+    std::vector<StageBusy> busy(workers + 2);
+    long failed = 0, largeImages = 0;
+    int finishedWorkers = 0, teamWorkers = 1;
+    double pixels = 0.0;
+
+    // Large images run a nested team; the process-wide nesting limit is restored after the batch
+    const int savedLevels = omp_get_max_active_levels();
+
+    omp_set_max_active_levels(2);
+
+    double start = omp_get_wtime();
+
+    #pragma omp parallel num_threads(workers + 2) reduction(+:failed, largeImages, pixels)
+    {
+        const int tid = omp_get_thread_num();
+        const int team = omp_get_num_threads();
+        const int stageWorkers = team - 2;
+
+        if (tid == 0)
+            teamWorkers = std::max(1, stageWorkers);
+
+        if (team < 3)
+        {
+            // Too small a team for the pipeline: loading, blurring and storing each image in turn
+            if (tid == 0)
+            {
+                for (const std::string& path : paths)
+                {
+                    std::unique_ptr<BatchImage> image = pool.acquire();
+
+                    double t0 = omp_get_wtime();
+
+                    image->path = path;
+                    image->loaded = loadBatchImage(*image);
+
+                    double t1 = omp_get_wtime();
+
+                    if (image->loaded)
+                    {
+                        blurBatchImage(*image, 1, options.isa);
+                        pixels += (double)image->info.width * image->info.height;
+                    }
+
+                    double t2 = omp_get_wtime();
+
+                    if (!image->loaded || !storeBatchImage(*image, options.outputDir))
+                        failed++;
+
+                    busy[0].seconds += t1 - t0;
+                    busy[1].seconds += t2 - t1;
+                    busy[2].seconds += omp_get_wtime() - t2;
+
+                    pool.release(std::move(image));
+                }
+            }
+        }
+        else if (tid == 0)
+        {
+            // Load stage
+            for (const std::string& path : paths)
+            {
+                std::unique_ptr<BatchImage> image = pool.acquire();
+
+                double t0 = omp_get_wtime();
+
+                image->path = path;
+                image->loaded = loadBatchImage(*image);
+
+                busy[0].seconds += omp_get_wtime() - t0;
+
+                toBlur.push(std::move(image));
+            }
+
+            toBlur.close();
+        }
+        else if (tid == stageWorkers + 1)
+        {
+            // Store stage
+            std::unique_ptr<BatchImage> image;
+
+            while (toStore.pop(image))
+            {
+                double t0 = omp_get_wtime();
+
+                if (!image->loaded || !storeBatchImage(*image, options.outputDir))
+                    failed++;
+
+                busy[tid].seconds += omp_get_wtime() - t0;
+
+                pool.release(std::move(image));
+            }
+        }
+        else
+        {
+            // Blur stage
+            std::unique_ptr<BatchImage> image;
+            int finished = 0;
+
+            while (toBlur.pop(image))
+            {
+                double t0 = omp_get_wtime();
+
+                if (image->loaded)
+                {
+                    long size = (long)image->info.width * image->info.height;
+
+                    if (size >= options.largeImagePixels && stageWorkers > 1)
+                    {
+                        std::unique_lock<std::shared_mutex> lock(coreLock);
+
+                        blurBatchImage(*image, stageWorkers, options.isa);
+
+                        largeImages++;
+                    }
+                    else
+                    {
+                        std::shared_lock<std::shared_mutex> lock(coreLock);
+
+                        blurBatchImage(*image, 1, options.isa);
+                    }
+
+                    pixels += (double)size;
+                }
+
+                busy[tid].seconds += omp_get_wtime() - t0;
+
+                toStore.push(std::move(image));
+            }
+
+            // The last worker to run dry closes the store queue
+            #pragma omp atomic capture
+            finished = ++finishedWorkers;
+
+            if (finished == stageWorkers)
+                toStore.close();
+        }
+    }
+
+    double end = omp_get_wtime();
+
+    omp_set_max_active_levels(savedLevels);
+
+    stats.images = (long)paths.size();
+    stats.failed = failed;
+    stats.largeImages = largeImages;
+    stats.allocated = pool.allocated;
+    stats.reused = pool.reused;
+    stats.workers = teamWorkers;
+    stats.pixels = pixels;
+    stats.seconds = end - start;
+    stats.loadBusy = busy[0].seconds;
+    stats.storeBusy = busy[teamWorkers + 1].seconds;
+
+    for (int w = 1; w <= teamWorkers; w++)
+        stats.blurBusy += busy[w].seconds;
+
+    return true;
+}
@@ -0,0 +1,173 @@
+/********************************************************************
+ * File:        fusedBlur.h
+ *
+ * Description: k-pass 3x3 box blur with temporal blocking. The image is cut
+ *              into cache-sized tiles; each tile is loaded together with a
+ *              halo of width k and all k passes are applied inside the
+ *              tile's scratch buffers before the center is written back.
+ *              Each pass shrinks the valid region by one pixel on every side
+ *              that is not an image edge, so the result is bit-identical to
+ *              k back-to-back calls of boxBlurParallel.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <unistd.h>
+#include <omp.h>
+
+#include "imageBuffer.h"
+
+// Picking a square tile edge so that both scratch buffers (tile plus halo) fit in half of L2.
+inline int defaultFusedTileSize(int passes, size_t pixelBytes)
+{
+    long l2 = 0;
+
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    if (l2 <= 0)
+        l2 = 1 << 20;  // Assume 1 MiB when the OS does not report it
+
+    int edge = (int)std::sqrt((double)l2 / 2.0 / 2.0 / (double)pixelBytes);
+
+    return std::max(32, edge - 2 * passes);
+}
+
+// One 3x3 pass over the local rows [rowBegin, rowEnd) and columns [colBegin, colEnd) of a tile
+// buffer whose origin sits at global (originRow, originCol).
+template <typename Pixel>
+void fusedTilePass(const Pixel* src, Pixel* dst, int pitch, int originRow, int originCol, int rows, int cols,
+                   int rowBegin, int rowEnd, int colBegin, int colEnd)
+{
+    // Local column range whose global column has both horizontal neighbors in the image
+    const int interiorBegin = std::max(colBegin, 1 - originCol);
+    const int interiorEnd = std::min(colEnd, cols - 1 - originCol);
+
+    for (int li = rowBegin; li < rowEnd; li++)
+    {
+        const int gi = originRow + li;
+        const Pixel* cur = src + (size_t)li * pitch;
+        const Pixel* up = gi > 0 ? cur - pitch : nullptr;
+        const Pixel* down = gi < rows - 1 ? cur + pitch : nullptr;
+        const int rowCount = 1 + (up != nullptr) + (down != nullptr);
+
+        Pixel* out = dst + (size_t)li * pitch;
+
+        // Sum of the in-bounds vertical taps at local column lj
+        auto column = [&](int lj) {
+            int sum = cur[lj];
+
+            if (up)
+                sum += up[lj];
+            if (down)
+                sum += down[lj];
+
+            return sum;
+        };
+
+        // Left image edge (global column 0)
+        for (int lj = colBegin; lj < std::min(interiorBegin, colEnd); lj++)
+        {
+            int hasRight = originCol + lj + 1 < cols;
+            int sum = column(lj) + (hasRight ? column(lj + 1) : 0);
+            int colCount = 1 + hasRight;
+
+            out[lj] = (Pixel)(sum / (rowCount * colCount));
+        }
+
+        if (up && down)
+        {
+            for (int lj = interiorBegin; lj < interiorEnd; lj++)
+            {
+                int sum = up[lj - 1]   + up[lj]   + up[lj + 1]
+                        + cur[lj - 1]  + cur[lj]  + cur[lj + 1]
+                        + down[lj - 1] + down[lj] + down[lj + 1];
+
+                out[lj] = (Pixel)(sum / 9);
+            }
+        }
+        else
+        {
+            for (int lj = interiorBegin; lj < interiorEnd; lj++)
+                out[lj] = (Pixel)((column(lj - 1) + column(lj) + column(lj + 1)) / (rowCount * 3));
+        }
+
+        // Right image edge (global column cols-1)
+        for (int lj = std::max(interiorEnd, interiorBegin); lj < colEnd; lj++)
+        {
+            int hasLeft = originCol + lj > 0;
+            int sum = column(lj) + (hasLeft ? column(lj - 1) : 0);
+            int colCount = 1 + hasLeft;
+
+            out[lj] = (Pixel)(sum / (rowCount * colCount));
+        }
+    }
+}
+
+// Applying `passes` 3x3 blurs to input and writing the result to output, tile by tile.
+template <typename Pixel>
+void boxBlurFused(const ImageBuffer<Pixel>& input, ImageBuffer<Pixel>& output, int passes, int tileSize)
+{
+    const int rows = input.rows, cols = input.cols;
+
+    if (passes <= 0)
+    {
+        output = input;
+
+        return;
+    }
+
+    const int tileRows = (rows + tileSize - 1) / tileSize;
+    const int tileCols = (cols + tileSize - 1) / tileSize;
+    const int scratchEdge = tileSize + 2 * passes;
+
+    #pragma omp parallel
+    {
+        // Per-thread ping-pong buffers, reused for every tile this thread processes
+        std::vector<Pixel> bufA((size_t)scratchEdge * scratchEdge), bufB((size_t)scratchEdge * scratchEdge);
+
+        #pragma omp for collapse(2) schedule(dynamic)
+        for (int tr = 0; tr < tileRows; tr++)
+        {
+            for (int tc = 0; tc < tileCols; tc++)
+            {
+                const int r0 = tr * tileSize, r1 = std::min(rows, r0 + tileSize);
+                const int c0 = tc * tileSize, c1 = std::min(cols, c0 + tileSize);
+
+                // Tile plus halo, clipped to the image
+                const int R0 = std::max(0, r0 - passes), R1 = std::min(rows, r1 + passes);
+                const int C0 = std::max(0, c0 - passes), C1 = std::min(cols, c1 + passes);
+                const int h = R1 - R0, w = C1 - C0;
+
+                Pixel* src = bufA.data();
+                Pixel* dst = bufB.data();
+
+                for (int li = 0; li < h; li++)
+                    std::copy(input.row(R0 + li) + C0, input.row(R0 + li) + C1, src + (size_t)li * w);
+
+                for (int p = 1; p <= passes; p++)
+                {
+                    // The valid region loses one pixel per pass on every side that is not an image edge
+                    int rowBegin = R0 > 0 ? p : 0;
+                    int rowEnd = R1 < rows ? h - p : h;
+                    int colBegin = C0 > 0 ? p : 0;
+                    int colEnd = C1 < cols ? w - p : w;
+
+                    fusedTilePass(src, dst, w, R0, C0, rows, cols, rowBegin, rowEnd, colBegin, colEnd);
+
+                    std::swap(src, dst);
+                }
+
+                for (int gi = r0; gi < r1; gi++)
+                {
+                    const Pixel* line = src + (size_t)(gi - R0) * w + (c0 - C0);
+
+                    std::copy(line, line + (c1 - c0), output.row(gi) + c0);
+                }
+            }
+        }
+    }
+}
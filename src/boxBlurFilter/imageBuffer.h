@@ -0,0 +1,100 @@
+/********************************************************************
+ * File:        imageBuffer.h
+ *
+ * Description: Contiguous, row-pitched grayscale image storage used by the
+ *              newer blur engines. Rows are padded so every row starts on
+ *              a 64-byte boundary relative to the buffer start, which keeps
+ *              rows from sharing cache lines between threads.
+ ********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+template <typename Pixel>
+struct ImageBuffer
+{
+    int rows = 0;
+    int cols = 0;
+    int pitch = 0;  // Row stride in pixels (>= cols)
+
+    std::vector<Pixel> data;
+
+    ImageBuffer() = default;
+
+    ImageBuffer(int r, int c, Pixel value = Pixel())
+    {
+        allocate(r, c, value);
+    }
+
+    void allocate(int r, int c, Pixel value = Pixel())
+    {
+        reshape(r, c);
+
+        data.assign((size_t)rows * pitch, value);
+    }
+
+    // Changing the shape while keeping the existing allocation when it is large enough (contents undefined).
+    void reshape(int r, int c)
+    {
+        const int lineElems = (int)(64 / sizeof(Pixel)) > 0 ? (int)(64 / sizeof(Pixel)) : 1;
+
+        rows = r;
+        cols = c;
+        pitch = ((c + lineElems - 1) / lineElems) * lineElems;
+
+        data.resize((size_t)rows * pitch);
+    }
+
+    Pixel* row(int i) { return data.data() + (size_t)i * pitch; }
+    const Pixel* row(int i) const { return data.data() + (size_t)i * pitch; }
+
+    Pixel& at(int i, int j) { return row(i)[j]; }
+    const Pixel& at(int i, int j) const { return row(i)[j]; }
+};
+
+// Copying a nested-vector image (the layout used by boxBlurSequential) into a flat buffer.
+template <typename Pixel>
+ImageBuffer<Pixel> toImageBuffer(const std::vector<std::vector<int>>& grid, int rows, int cols)
+{
+    ImageBuffer<Pixel> image(rows, cols);
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+            image.at(i, j) = (Pixel)grid[i][j];
+    }
+
+    return image;
+}
+
+// Filling a buffer with values that differ from the reference at every pixel, so a pass that leaves
+// pixels unwritten cannot match the reference by accident.
+template <typename Pixel>
+void poisonImage(ImageBuffer<Pixel>& image, const std::vector<std::vector<int>>& reference)
+{
+    for (int i = 0; i < image.rows; i++)
+    {
+        for (int j = 0; j < image.cols; j++)
+            image.at(i, j) = (Pixel)(reference[i][j] ^ 1);
+    }
+}
+
+// Comparing a flat buffer against a nested-vector reference; returns the number of mismatching pixels.
+template <typename Pixel>
+long long countMismatches(const ImageBuffer<Pixel>& image, const std::vector<std::vector<int>>& reference)
+{
+    long long mismatches = 0;
+
+    for (int i = 0; i < image.rows; i++)
+    {
+        for (int j = 0; j < image.cols; j++)
+        {
+            if ((int)image.at(i, j) != reference[i][j])
+                mismatches++;
+        }
+    }
+
+    return mismatches;
+}
@@ -14,14 +14,29 @@
 
 #include <iostream>
 #include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <memory>
 #include <omp.h>
 
+#include "imageBuffer.h"
+#include "separableBlur.h"
+#include "simdBlur.h"
+#include "fusedBlur.h"
+#include "streamingBlur.h"
+#include "batchBlur.h"
+#include "../common/autotuner.h"
+#include "../common/benchmarkHarness.h"
+#include "../common/numaPlacement.h"
+
 using namespace std;
 
 # define NUM_THREADS 4
 
-// Sequential box blur implementation
-void boxBlurSequential(const vector<vector<int>>& input, vector<vector<int>>& output, int rows, int cols) 
+// Sequential box blur implementation (radius 1 gives the 3x3 kernel; also the reference for the other engines)
+void boxBlurSequential(const vector<vector<int>>& input, vector<vector<int>>& output, int rows, int cols, int radius = 1) 
 {
     for (int i = 0; i < rows; i++) 
     {
@@ -29,10 +44,10 @@ void boxBlurSequential(const vector<vector<int>>& input, vector<vector<int>>& ou
         {
             int sum = 0, count = 0;
         
-            // Iterating over the 3x3 neighborhood
-            for (int di = -1; di <= 1; di++) 
+            // Iterating over the (2*radius+1)x(2*radius+1) neighborhood
+            for (int di = -radius; di <= radius; di++) 
             {
-                for (int dj = -1; dj <= 1; dj++) 
+                for (int dj = -radius; dj <= radius; dj++) 
                 {
                     int ni = i + di;
                     int nj = j + dj;
@@ -55,8 +70,10 @@ void boxBlurSequential(const vector<vector<int>>& input, vector<vector<int>>& ou
 // Parallel box blur implementation using OpenMP
 void boxBlurParallel(const vector<vector<int>>& input, vector<vector<int>>& output, int rows, int cols) 
 {
-    // Collapsing two loops to allow parallelization across both dimensions
-    #pragma omp parallel for collapse(2)
+    // Whole rows per thread. The schedule defaults to static partitioning (initRuntimeSchedule), matching
+    // makeFirstTouchGrid, so each thread reads and writes rows whose pages were first touched on its own
+    // NUMA node; --autotune may pick another schedule and chunk for this machine and size
+    #pragma omp parallel for schedule(runtime)
     for (int i = 0; i < rows; i++) 
     {
         for (int j = 0; j < cols; j++) 
@@ -86,48 +103,769 @@ void boxBlurParallel(const vector<vector<int>>& input, vector<vector<int>>& outp
     }
 }
 
-int main() 
+// Command line options
+// --engine naive|separable|simd|fused
+//                            Blur implementation (default: naive 3x3 gather)
+// --mode sequential|parallel|both
+// --radius R                 Kernel radius for the separable engine (default: 1, i.e. 3x3)
+// --sizes N1,N2,...          Square image sizes to sweep (default: 1000,2000,3000,5000)
+// --depth 8|16               Pixel depth for the simd engine (default: 8)
+// --isa auto|scalar|sse2|avx2
+//                            Interior kernel for the simd engine (default: auto)
+// --passes K                 Number of 3x3 passes for the fused engine (default: 3)
+// --tile T                   Tile edge for the fused engine (default: derived from the L2 size)
+// --verify                   Compare the selected engine against boxBlurSequential
+//                            (fused: against K back-to-back boxBlurParallel calls)
+// --input FILE --output FILE Stream-blur an 8/16-bit PGM (P5) file instead of the size sweep
+// --raw WxH                  Treat --input as headerless raw samples (host byte order, --depth bits)
+// --band-budget MiB          Memory shared by all bands in flight while streaming (default: 64)
+// --bench                    Run the registered variants through the shared benchmark harness
+//                            (see benchmarkUsage() for the --bench-* options)
+// --places P / --bind B      OMP_PLACES / OMP_PROC_BIND for this run (the program restarts itself to apply them)
+// --placement                Print the core and NUMA node of every thread before running
+// --batch DIR|LIST --output DIR
+//                            Blur every .pgm in DIR (or every path listed in LIST) into DIR
+// --batch-workers W          Blur workers in the batch pipeline (default: threads - 2)
+// --batch-large PIXELS       Images this large are blurred with all workers (default: 1048576)
+// --autotune                 After the naive parallel sweep, run the 3x3 blur with the engine (row kernel, separable,
+//                            simd or fused), schedule, chunk, tile and thread count tuned for this size and CPU
+//                            (cached in --tune-cache, default autotune.cache)
+// --retune                   Like --autotune, but measure again instead of using the cached winner
+// --tune-reps N              Timed runs per candidate while tuning (default: 3)
+struct BlurOptions
 {
-    // Image sizes to test
-    int sizes[] = {1000, 2000, 3000, 5000};
+    string engine = "naive";
+    string mode = "both";
 
-    // Looping over each image size
-    for (int s = 0; s < 4; s++) 
+    int depth = 8;
+    int passes = 3;
+    int tile = 0;
+
+    SimdLevel isa = detectSimdLevel();
+
+    vector<int> sizes = {1000, 2000, 3000, 5000};
+
+    int radius = 1;
+
+    bool verify = false;
+
+    StreamingOptions stream;
+    BatchOptions batch;
+
+    bool bench = false;
+
+    BenchmarkConfig benchConfig;
+    PlacementConfig placement;
+    AutotuneOptions tuning;
+};
+
+void printUsage(const char* program)
+{
+    cout << "Usage: " << program << " [--engine naive|separable|simd|fused] [--mode sequential|parallel|both]"
+         << " [--radius R] [--sizes N1,N2,...] [--depth 8|16] [--isa auto|scalar|sse2|avx2]"
+         << " [--passes K] [--tile T] [--verify] " << placementUsage() << " " << autotuneUsage() << endl;
+    cout << "       " << program << " --input FILE --output FILE [--raw WxH --depth 8|16] [--band-budget MiB]"
+         << " [--isa auto|scalar|sse2|avx2]" << endl;
+    cout << "       " << program << " --bench [--sizes N1,N2,...] " << benchmarkUsage() << endl;
+    cout << "       " << program << " --batch DIR|LIST --output DIR [--batch-workers W] [--batch-large PIXELS]"
+         << " [--isa auto|scalar|sse2|avx2]" << endl;
+}
+
+bool parseOptions(int argc, char* argv[], BlurOptions& options)
+{
+    for (int a = 1; a < argc; a++)
     {
-        int rows = sizes[s], cols = sizes[s];
-    
-        // Creating an image with constant pixel intensity (e.g., 128)
-        vector<vector<int>> input(rows, vector<int>(cols, 128));
-        vector<vector<int>> output(rows, vector<int>(cols, 0));
+        string arg = argv[a];
 
-        // Measuring sequential execution time
+        if (arg == "--engine" && a + 1 < argc)
+            options.engine = argv[++a];
+        else if (arg == "--mode" && a + 1 < argc)
+            options.mode = argv[++a];
+        else if (arg == "--radius" && a + 1 < argc)
+            options.radius = atoi(argv[++a]);
+        else if (arg == "--sizes" && a + 1 < argc)
+        {
+            options.sizes.clear();
+
+            for (char* tok = strtok(argv[++a], ","); tok != NULL; tok = strtok(NULL, ","))
+                options.sizes.push_back(atoi(tok));
+        }
+        else if (arg == "--depth" && a + 1 < argc)
+            options.depth = atoi(argv[++a]);
+        else if (arg == "--isa" && a + 1 < argc)
+        {
+            if (!parseSimdLevel(argv[++a], options.isa))
+                return false;
+        }
+        else if (arg == "--passes" && a + 1 < argc)
+            options.passes = atoi(argv[++a]);
+        else if (arg == "--tile" && a + 1 < argc)
+            options.tile = atoi(argv[++a]);
+        else if (arg == "--input" && a + 1 < argc)
+            options.stream.inputPath = argv[++a];
+        else if (arg == "--output" && a + 1 < argc)
+            options.stream.outputPath = argv[++a];
+        else if (arg == "--raw" && a + 1 < argc)
+        {
+            options.stream.raw = true;
+
+            if (sscanf(argv[++a], "%dx%d", &options.stream.rawWidth, &options.stream.rawHeight) != 2)
+                return false;
+        }
+        else if (arg == "--band-budget" && a + 1 < argc)
+            options.stream.bandBudgetBytes = (size_t)atol(argv[++a]) << 20;
+        else if (arg == "--batch" && a + 1 < argc)
+            options.batch.source = argv[++a];
+        else if (arg == "--batch-workers" && a + 1 < argc)
+            options.batch.workers = atoi(argv[++a]);
+        else if (arg == "--batch-large" && a + 1 < argc)
+            options.batch.largeImagePixels = atol(argv[++a]);
+        else if (arg == "--verify")
+            options.verify = true;
+        else if (arg == "--bench")
+            options.bench = true;
+        else if (parsePlacementOption(a, argc, argv, options.placement))
+            continue;
+        else if (parseAutotuneOption(a, argc, argv, options.tuning))
+            continue;
+        else if (arg.compare(0, 8, "--bench-") == 0)
+        {
+            if (!parseBenchmarkOption(a, argc, argv, options.benchConfig))
+                return false;
+        }
+        else
+            return false;
+    }
+
+    if (options.engine != "naive" && options.engine != "separable" && options.engine != "simd" && options.engine != "fused")
+        return false;
+    if (options.passes < 1 || options.tile < 0)
+        return false;
+    if (options.depth != 8 && options.depth != 16)
+        return false;
+    if (options.mode != "sequential" && options.mode != "parallel" && options.mode != "both")
+        return false;
+    options.stream.rawDepth = options.depth;
+    options.stream.isa = options.isa;
+
+    options.batch.isa = options.isa;
+
+    if (!options.batch.source.empty())
+    {
+        // In batch mode --output names the destination directory
+        options.batch.outputDir = options.stream.outputPath;
+
+        if (options.batch.outputDir.empty() || !options.stream.inputPath.empty() || options.batch.workers < 0)
+            return false;
+
+        options.stream.outputPath.clear();
+    }
+    if (options.stream.inputPath.empty() != options.stream.outputPath.empty())
+        return false;
+    if (options.stream.raw && (options.stream.rawWidth <= 0 || options.stream.rawHeight <= 0))
+        return false;
+    if (options.stream.bandBudgetBytes == 0)
+        return false;
+
+    for (int n : options.sizes)
+    {
+        if (n <= 0)
+            return false;
+    }
+    if (options.sizes.empty() || options.radius < 1 || (options.engine != "separable" && options.radius != 1))
+        return false;
+
+    return true;
+}
+
+// Running the separable engine on one image size
+void runSeparable(const BlurOptions& options, int rows, int cols)
+{
+    int kernel = 2 * options.radius + 1;
+
+    ImageBuffer<int> input(rows, cols, 128);
+    ImageBuffer<int> output(rows, cols, 0);
+
+    if (options.verify)
+    {
+        // Non-constant pattern so the border averaging is actually exercised
+        vector<vector<int>> ref(rows, vector<int>(cols));
+        vector<vector<int>> refOut(rows, vector<int>(cols, 0));
+
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < cols; j++)
+                ref[i][j] = (i * 31 + j * 17 + (i * j) % 13) % 256;
+        }
+
+        input = toImageBuffer<int>(ref, rows, cols);
+
+        boxBlurSequential(ref, refOut, rows, cols, options.radius);
+
+        poisonImage(output, refOut);
+        boxBlurSeparableSequential(input, output, options.radius);
+        cout << "-> Verify sequential " << kernel << "x" << kernel << ": "
+             << countMismatches(output, refOut) << " mismatching pixels." << endl;
+
+        poisonImage(output, refOut);
+        boxBlurSeparableParallel(input, output, options.radius);
+        cout << "-> Verify parallel " << kernel << "x" << kernel << ": "
+             << countMismatches(output, refOut) << " mismatching pixels." << endl << endl;
+    }
+
+    if (options.mode != "parallel")
+    {
         double start = omp_get_wtime();
 
-        boxBlurSequential(input, output, rows, cols);
-        
+        boxBlurSeparableSequential(input, output, options.radius);
+
         double end = omp_get_wtime();
-        
-        cout << "> Sequential Execution:" << endl;
+
+        cout << "> Sequential Execution (separable " << kernel << "x" << kernel << "):" << endl;
         cout << "-> Time for " << rows << "x" << cols << " image: " << (end - start) << " seconds." << endl << endl;
+    }
 
-        // Measure parallel execution time (adjusting thread count as needed via environment variable or omp_set_num_threads)
+    if (options.mode != "sequential")
+    {
+        cout << "> Parallel Execution (separable " << kernel << "x" << kernel << "):" << endl;
+        for (int i = 2; i <= 16; i+=2) 
+        {
+            omp_set_num_threads(i);
+
+            double startP = omp_get_wtime();
+
+            boxBlurSeparableParallel(input, output, options.radius);
+
+            double endP = omp_get_wtime();
+
+            cout << "-> Time for " << rows << "x" << cols << " image: " << (endP - startP) << " seconds. Using " << i << " threads." << endl;
+        }
+    }
+}
+
+// Running the 8/16-bit simd engine on one image size
+template <typename Pixel>
+void runSimd(const BlurOptions& options, int rows, int cols)
+{
+    const int maxValue = (1 << options.depth) - 1;
+
+    ImageBuffer<Pixel> input(rows, cols, (Pixel)128);
+    ImageBuffer<Pixel> output(rows, cols, 0);
+
+    if (options.verify)
+    {
+        // Full-range pattern so the widest sums and the border counts are exercised
+        vector<vector<int>> ref(rows, vector<int>(cols));
+        vector<vector<int>> refOut(rows, vector<int>(cols, 0));
+
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < cols; j++)
+                ref[i][j] = ((i * 7919 + j * 104729 + (i ^ j)) % 5 == 0) ? maxValue : (i * 31 + j * 17) % (maxValue + 1);
+        }
+
+        input = toImageBuffer<Pixel>(ref, rows, cols);
+
+        boxBlurSequential(ref, refOut, rows, cols);
+
+        poisonImage(output, refOut);
+        boxBlurSimdSequential(input, output, options.isa);
+        cout << "-> Verify sequential (" << options.depth << "-bit, " << simdLevelName(options.isa) << "): "
+             << countMismatches(output, refOut) << " mismatching pixels." << endl;
+
+        poisonImage(output, refOut);
+        boxBlurSimdParallel(input, output, options.isa);
+        cout << "-> Verify parallel (" << options.depth << "-bit, " << simdLevelName(options.isa) << "): "
+             << countMismatches(output, refOut) << " mismatching pixels." << endl << endl;
+    }
+
+    if (options.mode != "parallel")
+    {
+        double start = omp_get_wtime();
+
+        boxBlurSimdSequential(input, output, options.isa);
+
+        double end = omp_get_wtime();
 
-        cout << "> Parallel Execution:" << endl;
+        cout << "> Sequential Execution (" << options.depth << "-bit, " << simdLevelName(options.isa) << "):" << endl;
+        cout << "-> Time for " << rows << "x" << cols << " image: " << (end - start) << " seconds." << endl << endl;
+    }
+
+    if (options.mode != "sequential")
+    {
+        cout << "> Parallel Execution (" << options.depth << "-bit, " << simdLevelName(options.isa) << "):" << endl;
         for (int i = 2; i <= 16; i+=2) 
         {
+            omp_set_num_threads(i);
+
             double startP = omp_get_wtime();
+
+            boxBlurSimdParallel(input, output, options.isa);
+
+            double endP = omp_get_wtime();
+
+            cout << "-> Time for " << rows << "x" << cols << " image: " << (endP - startP) << " seconds. Using " << i << " threads." << endl;
+        }
+    }
+}
+
+// Running k back-to-back 3x3 passes of boxBlurParallel (the unfused baseline); the result ends up in output.
+void boxBlurParallelPasses(vector<vector<int>>& input, vector<vector<int>>& output, int rows, int cols, int passes)
+{
+    for (int p = 0; p < passes; p++)
+    {
+        boxBlurParallel(input, output, rows, cols);
+
+        if (p + 1 < passes)
+            input.swap(output);
+    }
+}
+
+// Running the fused k-pass engine on one image size
+void runFused(const BlurOptions& options, int rows, int cols)
+{
+    int tile = options.tile > 0 ? options.tile : defaultFusedTileSize(options.passes, sizeof(int));
+
+    vector<vector<int>> ref(rows, vector<int>(cols));
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+            ref[i][j] = options.verify ? (i * 31 + j * 17 + (i * j) % 13) % 256 : 128;
+    }
+
+    ImageBuffer<int> input = toImageBuffer<int>(ref, rows, cols);
+    ImageBuffer<int> output(rows, cols, 0);
+
+    if (options.verify)
+    {
+        vector<vector<int>> work = ref, refOut(rows, vector<int>(cols, 0));
+
+        boxBlurParallelPasses(work, refOut, rows, cols, options.passes);
+
+        boxBlurFused(input, output, options.passes, tile);
+        cout << "-> Verify fused " << options.passes << "-pass (tile " << tile << "): "
+             << countMismatches(output, refOut) << " mismatching pixels." << endl << endl;
+    }
+
+    cout << "> " << options.passes << "-pass blur, tile " << tile << ":" << endl;
+    for (int i = 2; i <= 16; i+=2) 
+    {
+        omp_set_num_threads(i);
+
+        vector<vector<int>> work = ref, workOut(rows, vector<int>(cols, 0));
+
+        double startU = omp_get_wtime();
+
+        boxBlurParallelPasses(work, workOut, rows, cols, options.passes);
+
+        double endU = omp_get_wtime();
+
+        double startF = omp_get_wtime();
+
+        boxBlurFused(input, output, options.passes, tile);
+
+        double endF = omp_get_wtime();
+
+        cout << "-> Time for " << rows << "x" << cols << " image: unfused " << (endU - startU)
+             << " s, fused " << (endF - startF) << " s. Using " << i << " threads." << endl;
+    }
+}
+
+// Zeroing a benchmark output grid before a run (rows in parallel, like their first touch).
+void clearGrid(vector<vector<int>>& grid)
+{
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < grid.size(); i++)
+        fill(grid[i].begin(), grid[i].end(), 0);
+}
+
+// Registering the blur variants with the benchmark harness; every variant is checked against boxBlurSequential
+// (the fused engine against options.passes back-to-back boxBlurSequential passes). Each variant writes its own
+// output buffer, cleared before every run, so a variant that writes nothing cannot pass on another's result.
+void registerBlurBenchmarks(BenchmarkHarness& harness, int rows, int cols, const BlurOptions& options)
+{
+    const SimdLevel isa = options.isa;
+    const int passes = options.passes;
+    const int tile = options.tile > 0 ? options.tile : defaultFusedTileSize(passes, sizeof(int));
+
+    string size = to_string(rows) + "x" + to_string(cols);
+    double pixels = (double)rows * cols;
+
+    // Shared between the cases of one size; the closures keep them alive
+    auto source = make_shared<vector<vector<int>>>(makeFirstTouchGrid<int>(rows, cols, 0));
+    auto reference = make_shared<vector<vector<int>>>(rows, vector<int>(cols, 0));
+    auto sequentialOutput = make_shared<vector<vector<int>>>(makeFirstTouchGrid<int>(rows, cols, 0));
+    auto parallelOutput = make_shared<vector<vector<int>>>(makeFirstTouchGrid<int>(rows, cols, 0));
+    auto fusedReference = make_shared<vector<vector<int>>>(rows, vector<int>(cols, 0));
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+            (*source)[i][j] = (i * 31 + j * 17 + (i * j) % 13) % 256;
+    }
+
+    boxBlurSequential(*source, *reference, rows, cols);
+
+    // K passes for the fused engine, ping-ponging between two grids
+    vector<vector<int>> work = *source;
+
+    for (int p = 0; p < passes; p++)
+    {
+        boxBlurSequential(work, *fusedReference, rows, cols);
+
+        if (p + 1 < passes)
+            work.swap(*fusedReference);
+    }
+
+    auto flatInput = make_shared<ImageBuffer<int>>(toImageBuffer<int>(*source, rows, cols));
+    auto flatOutput = make_shared<ImageBuffer<int>>(rows, cols);
+    auto fusedOutput = make_shared<ImageBuffer<int>>(rows, cols);
+    auto input8 = make_shared<ImageBuffer<uint8_t>>(toImageBuffer<uint8_t>(*source, rows, cols));
+    auto output8 = make_shared<ImageBuffer<uint8_t>>(rows, cols);
+
+    BenchmarkCase c;
+
+    c.benchmark = "boxBlur";
+    c.size = size;
+    c.unit = "pixels";
+
+    c.variant = "sequential";
+    c.parallel = false;
+    c.setup = [=]() { clearGrid(*sequentialOutput); };
+    c.run = [=]() { boxBlurSequential(*source, *sequentialOutput, rows, cols); return pixels; };
+    c.verify = [=]() { return *sequentialOutput == *reference; };
+    harness.add(c);
+
+    c.variant = "parallel";
+    c.parallel = true;
+    c.setup = [=]() { clearGrid(*parallelOutput); };
+    c.run = [=]() { boxBlurParallel(*source, *parallelOutput, rows, cols); return pixels; };
+    c.verify = [=]() { return *parallelOutput == *reference; };
+    harness.add(c);
+
+    c.variant = "separable";
+    c.setup = [=]() { fill(flatOutput->data.begin(), flatOutput->data.end(), 0); };
+    c.run = [=]() { boxBlurSeparableParallel(*flatInput, *flatOutput, 1); return pixels; };
+    c.verify = [=]() { return countMismatches(*flatOutput, *reference) == 0; };
+    harness.add(c);
+
+    c.variant = string("simd8-") + simdLevelName(isa);
+    c.setup = [=]() { fill(output8->data.begin(), output8->data.end(), 0); };
+    c.run = [=]() { boxBlurSimdParallel(*input8, *output8, isa); return pixels; };
+    c.verify = [=]() { return countMismatches(*output8, *reference) == 0; };
+    harness.add(c);
+
+    c.variant = "fused" + to_string(passes);
+    c.setup = [=]() { fill(fusedOutput->data.begin(), fusedOutput->data.end(), 0); };
+    c.run = [=]() { boxBlurFused(*flatInput, *fusedOutput, passes, tile); return pixels * passes; };
+    c.verify = [=]() { return countMismatches(*fusedOutput, *fusedReference) == 0; };
+    harness.add(c);
+}
+
+// One 3x3 blur in the layouts of every engine the autotuner can pick; only the buffers the pixel range
+// allows are filled (8-bit for values below 256, 16-bit below 65536).
+struct BlurWorkspace
+{
+    int rows = 0, cols = 0;
+
+    ImageBuffer<int> in, out;
+    ImageBuffer<uint8_t> in8, out8;
+    ImageBuffer<uint16_t> in16, out16;
+};
+
+BlurWorkspace makeBlurWorkspace(const vector<vector<int>>& input, int rows, int cols, int maxValue)
+{
+    BlurWorkspace w;
+
+    w.rows = rows;
+    w.cols = cols;
+    w.in = toImageBuffer<int>(input, rows, cols);
+    w.out = ImageBuffer<int>(rows, cols, 0);
+
+    if (maxValue < 256)
+    {
+        w.in8 = toImageBuffer<uint8_t>(input, rows, cols);
+        w.out8 = ImageBuffer<uint8_t>(rows, cols, 0);
+    }
+    else if (maxValue < 65536)
+    {
+        w.in16 = toImageBuffer<uint16_t>(input, rows, cols);
+        w.out16 = ImageBuffer<uint16_t>(rows, cols, 0);
+    }
+
+    return w;
+}
+
+// Blurring w.rows rows with the engine of config: "rows" is boxBlurParallel on the nested vectors
+// (schedule(runtime)), the others run on the flat buffers of w.
+void runBlurConfig(const TuningConfig& config, const vector<vector<int>>& input, vector<vector<int>>& output,
+                   BlurWorkspace& w, SimdLevel isa)
+{
+    if (config.variant == "separable")
+        boxBlurSeparableParallel(w.in, w.out, 1);
+    else if (config.variant == "simd8")
+        boxBlurSimdParallel(w.in8, w.out8, isa);
+    else if (config.variant == "simd16")
+        boxBlurSimdParallel(w.in16, w.out16, isa);
+    else if (config.variant == "fused")
+        boxBlurFused(w.in, w.out, 1, config.tile);
+    else
+        boxBlurParallel(input, output, w.rows, w.cols);
+}
+
+// Running a 3x3 blur with the engine and configuration tuned for this image size: the row kernel with
+// several schedules, the separable, simd (at the narrowest depth that holds the pixels) and fused engines
+// (one pass, several tile edges), each at 1, 2, 4, ... threads. Candidates are timed on a band of rows
+// (an eighth of the image, at least 64 rows) so a cold cache costs about one full blur per candidate.
+void runAutotuned(Autotuner& tuner, const vector<vector<int>>& input, vector<vector<int>>& output, int rows, int cols,
+                  SimdLevel isa)
+{
+    const int sliceRows = min(rows, max(64, rows / 8));
+
+    int minValue = 0, maxValue = 0;
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            minValue = min(minValue, input[i][j]);
+            maxValue = max(maxValue, input[i][j]);
+        }
+    }
+
+    if (minValue < 0)
+        maxValue = INT32_MAX;  // Negative pixels only fit the int engines
+
+    vector<TuningConfig> candidates;
+
+    for (int threads : threadCandidates(tuner.getThreadBudget()))
+    {
+        TuningConfig c;
+
+        c.threads = threads;
+        c.variant = "rows";
+
+        for (auto schedule : {make_pair(omp_sched_static, 0), make_pair(omp_sched_static, 1), make_pair(omp_sched_static, 16),
+                              make_pair(omp_sched_dynamic, 1), make_pair(omp_sched_dynamic, 16), make_pair(omp_sched_guided, 1)})
+        {
+            c.schedule = schedule.first;
+            c.chunk = schedule.second;
+            candidates.push_back(c);
+        }
+
+        // The other engines fix their own schedules
+        c.schedule = omp_sched_static;
+        c.chunk = 0;
+
+        c.variant = "separable";
+        candidates.push_back(c);
+
+        if (maxValue < 65536)
+        {
+            c.variant = maxValue < 256 ? "simd8" : "simd16";
+            candidates.push_back(c);
+        }
+
+        c.variant = "fused";
+
+        for (int tile : {32, 64, 128, 256})
+        {
+            c.tile = tile;
+            candidates.push_back(c);
+        }
+
+        c.tile = 0;
+    }
+
+    BlurWorkspace slice = makeBlurWorkspace(input, sliceRows, cols, maxValue);
+
+    TuningConfig best = tuner.select("boxBlur3x3", to_string(rows) + "x" + to_string(cols), candidates,
+                                     [&](const TuningConfig& c) { runBlurConfig(c, input, output, slice, isa); }, NULL);
+
+    BlurWorkspace full = makeBlurWorkspace(input, rows, cols, maxValue);
+
+    applyTuning(best);
+
+    double start = omp_get_wtime();
+
+    runBlurConfig(best, input, output, full, isa);
+
+    double end = omp_get_wtime();
+
+    // Leaving the result in output whichever layout the engine used
+    for (int i = 0; i < rows && best.variant != "rows"; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            if (best.variant == "simd8")
+                output[i][j] = full.out8.at(i, j);
+            else if (best.variant == "simd16")
+                output[i][j] = full.out16.at(i, j);
+            else
+                output[i][j] = full.out.at(i, j);
+        }
+    }
+
+    cout << "> Autotuned Execution (" << describeTuning(best) << (tuner.wasCached() ? ", cached" : ", tuned now") << "):" << endl;
+    cout << "-> Time for " << rows << "x" << cols << " image: " << (end - start) << " seconds." << endl;
+
+    omp_set_num_threads(tuner.getThreadBudget());
+    initRuntimeSchedule();
+}
+
+int main(int argc, char* argv[]) 
+{
+    BlurOptions options;
+
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage(argv[0]);
+
+        return 1;
+    }
+
+    applyPlacement(options.placement, argv);
+    initRuntimeSchedule();
+
+    if (options.placement.report)
+        reportThreadPlacement(cout);
+
+    // Benchmarking every variant over the size sweep
+    if (options.bench)
+    {
+        BenchmarkHarness harness(options.benchConfig);
+
+        for (int n : options.sizes)
+            registerBlurBenchmarks(harness, n, n, options);
+
+        bool passed = harness.run();
+
+        harness.report();
+
+        return passed ? 0 : 1;
+    }
+
+    // Blurring a whole directory or file list through the batch pipeline
+    if (!options.batch.source.empty())
+    {
+        BatchStats stats;
+        string error;
+
+        if (!batchBlur(options.batch, stats, error))
+        {
+            cerr << "Error: " << error << endl;
+
+            return 1;
+        }
+
+        cout << "> Batch Execution (" << stats.workers << " blur workers, " << simdLevelName(options.isa) << "):" << endl;
+        cout << "-> " << stats.images << " images (" << stats.failed << " failed, " << stats.largeImages
+             << " blurred within-image) in " << stats.seconds << " seconds: " << stats.images / stats.seconds
+             << " images/s, " << stats.pixels / stats.seconds / 1e6 << " MPixel/s." << endl;
+        cout << "-> Stage utilization: load " << 100.0 * stats.loadBusy / stats.seconds << "%, blur "
+             << 100.0 * stats.blurBusy / (stats.seconds * stats.workers) << "%, store "
+             << 100.0 * stats.storeBusy / stats.seconds << "%." << endl;
+        cout << "-> Buffer pool: " << stats.allocated << " allocated, " << stats.reused << " reused." << endl;
+
+        return stats.failed == 0 ? 0 : 1;
+    }
+
+    // Streaming a real image file through the out-of-core engine
+    if (!options.stream.inputPath.empty())
+    {
+        StreamingStats stats;
+        string error;
+
+        if (!streamingBlur(options.stream, stats, error))
+        {
+            cerr << "Error: " << error << endl;
+
+            return 1;
+        }
+
+        double megabytes = (double)stats.width * stats.height * stats.bytesPerPixel / (1 << 20);
+
+        cout << "> Streaming Execution (" << 8 * stats.bytesPerPixel << "-bit, " << simdLevelName(options.isa) << "):" << endl;
+        cout << "-> Time for " << stats.height << "x" << stats.width << " image: " << stats.seconds << " seconds ("
+             << megabytes / stats.seconds << " MiB/s). Using " << stats.threads << " threads." << endl;
+        cout << "-> " << stats.bands << " bands of " << stats.bandRows << " rows, peak RSS "
+             << stats.peakRssKb / 1024 << " MiB." << endl;
+
+        return 0;
+    }
+
+    // Created before the sweep changes the thread count, so the cache is keyed by the real thread budget
+    unique_ptr<Autotuner> tuner;
+
+    if (options.tuning.enabled)
+        tuner.reset(new Autotuner(options.tuning));
+
+    // Looping over each image size
+    for (int s = 0; s < (int)options.sizes.size(); s++) 
+    {
+        int rows = options.sizes[s], cols = options.sizes[s];
+
+        if (options.engine != "naive")
+        {
+            if (options.engine == "separable")
+                runSeparable(options, rows, cols);
+            else if (options.engine == "fused")
+                runFused(options, rows, cols);
+            else if (options.depth == 8)
+                runSimd<uint8_t>(options, rows, cols);
+            else
+                runSimd<uint16_t>(options, rows, cols);
+
+            cout << "\n--------------------------------------------------------------------------------" << endl << endl;
+
+            continue;
+        }
     
-            omp_set_num_threads(i);  
+        // Creating an image with constant pixel intensity (e.g., 128), first touched by the owning threads
+        vector<vector<int>> input = makeFirstTouchGrid<int>(rows, cols, 128);
+        vector<vector<int>> output = makeFirstTouchGrid<int>(rows, cols, 0);
+
+        // Measuring sequential execution time
+        if (options.mode != "parallel")
+        {
+            double start = omp_get_wtime();
+
+            boxBlurSequential(input, output, rows, cols);
             
-            boxBlurParallel(input, output, rows, cols);
+            double end = omp_get_wtime();
             
-            double endP = omp_get_wtime();
-            
-            cout << "-> Time for " << rows << "x" << cols << " image: " << (endP - startP) << " seconds. Using " << i << " threads." << endl;
+            cout << "> Sequential Execution:" << endl;
+            cout << "-> Time for " << rows << "x" << cols << " image: " << (end - start) << " seconds." << endl << endl;
+        }
+
+        // Measure parallel execution time (adjusting thread count as needed via environment variable or omp_set_num_threads)
+        if (options.mode != "sequential")
+        {
+            cout << "> Parallel Execution:" << endl;
+            for (int i = 2; i <= 16; i+=2) 
+            {
+                omp_set_num_threads(i);  
+                
+                double startP = omp_get_wtime();
+        
+                boxBlurParallel(input, output, rows, cols);
+                
+                double endP = omp_get_wtime();
+                
+                cout << "-> Time for " << rows << "x" << cols << " image: " << (endP - startP) << " seconds. Using " << i << " threads." << endl;
+            }
+
+            if (tuner)
+            {
+                cout << endl;
+
+                runAutotuned(*tuner, input, output, rows, cols, options.isa);
+            }
         }
 
         cout << "\n--------------------------------------------------------------------------------" << endl << endl;
     }
 
     return 0;
-}
+}
\ No newline at end of file
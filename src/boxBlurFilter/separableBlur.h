@@ -0,0 +1,147 @@
+/********************************************************************
+ * File:        separableBlur.h
+ *
+ * Description: Separable box blur with an arbitrary radius. A horizontal
+ *              pass computes clipped running sums along each row, then a
+ *              vertical pass slides a running sum down each column, so the
+ *              cost per pixel does not depend on the kernel size. Border
+ *              pixels are divided by the number of in-bounds neighbors,
+ *              exactly like boxBlurSequential.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <omp.h>
+
+#include "imageBuffer.h"
+
+// Number of in-bounds taps of a window of the given radius centered at index i.
+inline int clippedWindowCount(int i, int n, int radius)
+{
+    return std::min(n - 1, i + radius) - std::max(0, i - radius) + 1;
+}
+
+// Horizontal running sum over one row: out[j] = sum of in[j-radius .. j+radius] clipped to the row.
+template <typename Pixel>
+void horizontalRunningSum(const Pixel* in, int* out, int cols, int radius)
+{
+    int sum = 0;
+
+    for (int j = 0; j <= radius && j < cols; j++)
+        sum += in[j];
+
+    for (int j = 0; j < cols; j++)
+    {
+        out[j] = sum;
+
+        int enter = j + radius + 1;
+        int leave = j - radius;
+
+        if (enter < cols)
+            sum += in[enter];
+        if (leave >= 0)
+            sum -= in[leave];
+    }
+}
+
+// Vertical running sum over rows [rowBegin, rowEnd) of the horizontal sums, writing averaged pixels.
+template <typename Pixel>
+void verticalRunningSum(const ImageBuffer<int>& rowSums, ImageBuffer<Pixel>& output, int rowBegin, int rowEnd,
+                        int radius, const std::vector<int>& colCounts, std::vector<int>& acc)
+{
+    const int rows = rowSums.rows;
+    const int cols = rowSums.cols;
+
+    if (rowBegin >= rowEnd)
+        return;
+
+    // Priming the accumulator with the window of the first row in the band
+    std::fill(acc.begin(), acc.begin() + cols, 0);
+
+    for (int k = std::max(0, rowBegin - radius); k <= std::min(rows - 1, rowBegin + radius); k++)
+    {
+        const int* src = rowSums.row(k);
+
+        for (int j = 0; j < cols; j++)
+            acc[j] += src[j];
+    }
+
+    for (int i = rowBegin; i < rowEnd; i++)
+    {
+        const int rowCount = clippedWindowCount(i, rows, radius);
+        Pixel* dst = output.row(i);
+
+        for (int j = 0; j < cols; j++)
+            dst[j] = (Pixel)(acc[j] / (rowCount * colCounts[j]));
+
+        int enter = i + radius + 1;
+        int leave = i - radius;
+
+        if (enter < rows)
+        {
+            const int* src = rowSums.row(enter);
+
+            for (int j = 0; j < cols; j++)
+                acc[j] += src[j];
+        }
+        if (leave >= 0)
+        {
+            const int* src = rowSums.row(leave);
+
+            for (int j = 0; j < cols; j++)
+                acc[j] -= src[j];
+        }
+    }
+}
+
+// Sequential separable box blur with a (2*radius+1)^2 kernel
+template <typename Pixel>
+void boxBlurSeparableSequential(const ImageBuffer<Pixel>& input, ImageBuffer<Pixel>& output, int radius)
+{
+    const int rows = input.rows, cols = input.cols;
+
+    ImageBuffer<int> rowSums(rows, cols);
+    std::vector<int> colCounts(cols), acc(cols);
+
+    for (int j = 0; j < cols; j++)
+        colCounts[j] = clippedWindowCount(j, cols, radius);
+
+    for (int i = 0; i < rows; i++)
+        horizontalRunningSum(input.row(i), rowSums.row(i), cols, radius);
+
+    verticalRunningSum(rowSums, output, 0, rows, radius, colCounts, acc);
+}
+
+// Parallel separable box blur. The horizontal pass is split by rows; the vertical
+// pass gives each thread one contiguous band so it only primes its accumulator once.
+template <typename Pixel>
+void boxBlurSeparableParallel(const ImageBuffer<Pixel>& input, ImageBuffer<Pixel>& output, int radius)
+{
+    const int rows = input.rows, cols = input.cols;
+
+    ImageBuffer<int> rowSums(rows, cols);
+    std::vector<int> colCounts(cols);
+
+    for (int j = 0; j < cols; j++)
+        colCounts[j] = clippedWindowCount(j, cols, radius);
+
+    #pragma omp parallel
+    {
+        std::vector<int> acc(cols);
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < rows; i++)
+            horizontalRunningSum(input.row(i), rowSums.row(i), cols, radius);
+
+        // Implicit barrier above: every row sum is ready before the vertical pass
+
+        int nthreads = omp_get_num_threads();
+        int tid = omp_get_thread_num();
+        int rowBegin = (int)((long long)rows * tid / nthreads);
+        int rowEnd = (int)((long long)rows * (tid + 1) / nthreads);
+
+        verticalRunningSum(rowSums, output, rowBegin, rowEnd, radius, colCounts, acc);
+    }
+}
@@ -0,0 +1,335 @@
+/********************************************************************
+ * File:        simdBlur.h
+ *
+ * Description: 3x3 box blur kernels for 8-bit and 16-bit grayscale images.
+ *              Each row is split into a branch-free interior (every tap is
+ *              in bounds, so the divisor is always 9) and a scalar border
+ *              path that applies the same clipped-count averaging as
+ *              boxBlurSequential. The interior has SSE2 and AVX2 versions
+ *              selected at runtime, with a portable scalar fallback.
+ ********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <omp.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BLUR_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define BLUR_HAVE_X86 0
+#endif
+
+#include "imageBuffer.h"
+
+enum class SimdLevel { Scalar, Sse2, Avx2 };
+
+inline const char* simdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Sse2: return "sse2";
+        default:              return "scalar";
+    }
+}
+
+// Best instruction set supported by the running CPU
+inline SimdLevel detectSimdLevel()
+{
+#if BLUR_HAVE_X86
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::Avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return SimdLevel::Sse2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+// Parsing "auto", "scalar", "sse2" or "avx2"; a request above what the CPU supports is clamped down.
+inline bool parseSimdLevel(const std::string& name, SimdLevel& level)
+{
+    SimdLevel best = detectSimdLevel();
+
+    if (name == "auto")
+        level = best;
+    else if (name == "scalar")
+        level = SimdLevel::Scalar;
+    else if (name == "sse2")
+        level = SimdLevel::Sse2;
+    else if (name == "avx2")
+        level = SimdLevel::Avx2;
+    else
+        return false;
+
+    if ((int)level > (int)best)
+        level = best;
+
+    return true;
+}
+
+// Scalar path for any span of a row. above/below are null on the first/last image row.
+template <typename Pixel>
+void blurSpanBorder(const Pixel* above, const Pixel* cur, const Pixel* below, Pixel* out,
+                    int cols, int colBegin, int colEnd)
+{
+    const int rowCount = 1 + (above != nullptr) + (below != nullptr);
+
+    for (int j = colBegin; j < colEnd; j++)
+    {
+        int jl = j > 0 ? j - 1 : j;
+        int jr = j < cols - 1 ? j + 1 : j;
+        int sum = 0;
+
+        for (int k = jl; k <= jr; k++)
+        {
+            sum += cur[k];
+
+            if (above)
+                sum += above[k];
+            if (below)
+                sum += below[k];
+        }
+
+        out[j] = (Pixel)(sum / (rowCount * (jr - jl + 1)));
+    }
+}
+
+// Branch-free scalar interior: all nine taps valid for colBegin >= 1 and colEnd <= cols - 1.
+template <typename Pixel>
+void blurSpanInteriorScalar(const Pixel* above, const Pixel* cur, const Pixel* below, Pixel* out,
+                            int colBegin, int colEnd)
+{
+    for (int j = colBegin; j < colEnd; j++)
+    {
+        int sum = above[j - 1] + above[j] + above[j + 1]
+                + cur[j - 1]   + cur[j]   + cur[j + 1]
+                + below[j - 1] + below[j] + below[j + 1];
+
+        out[j] = (Pixel)(sum / 9);
+    }
+}
+
+#if BLUR_HAVE_X86
+
+// Exact unsigned 32-bit division by 9: (x * 0x38E38E39) >> 33
+inline __m128i div9Epu32Sse2(__m128i x)
+{
+    const __m128i magic = _mm_set1_epi32(0x38E38E39);
+
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(x, magic), 33);
+    __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), magic), 33);
+
+    return _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+}
+
+__attribute__((target("avx2")))
+inline __m256i div9Epu32Avx2(__m256i x)
+{
+    const __m256i magic = _mm256_set1_epi32(0x38E38E39);
+
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, magic), 33);
+    __m256i odd = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), magic), 33);
+
+    return _mm256_or_si256(even, _mm256_slli_epi64(odd, 32));
+}
+
+// 8-bit interior, 16 pixels per step. Sums fit in 16 bits (max 9*255), and for
+// those mulhi by 7282 is an exact division by 9. Returns the first unprocessed column.
+inline int blurSpanInteriorSse2(const uint8_t* above, const uint8_t* cur, const uint8_t* below, uint8_t* out,
+                                int colBegin, int colEnd)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i inv9 = _mm_set1_epi16(7282);
+    const uint8_t* rowPtrs[3] = {above, cur, below};
+
+    int j = colBegin;
+
+    for (; j + 16 <= colEnd; j += 16)
+    {
+        __m128i lo = zero, hi = zero;
+
+        for (int r = 0; r < 3; r++)
+        {
+            for (int d = -1; d <= 1; d++)
+            {
+                __m128i v = _mm_loadu_si128((const __m128i*)(rowPtrs[r] + j + d));
+
+                lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+                hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+            }
+        }
+
+        lo = _mm_mulhi_epu16(lo, inv9);
+        hi = _mm_mulhi_epu16(hi, inv9);
+
+        _mm_storeu_si128((__m128i*)(out + j), _mm_packus_epi16(lo, hi));
+    }
+
+    return j;
+}
+
+// 16-bit interior, 8 pixels per step. Sums are widened to 32 bits; SSE2 has no
+// unsigned 32->16 pack, so results are biased into signed range and back.
+inline int blurSpanInteriorSse2(const uint16_t* above, const uint16_t* cur, const uint16_t* below, uint16_t* out,
+                                int colBegin, int colEnd)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+    const uint16_t* rowPtrs[3] = {above, cur, below};
+
+    int j = colBegin;
+
+    for (; j + 8 <= colEnd; j += 8)
+    {
+        __m128i lo = zero, hi = zero;
+
+        for (int r = 0; r < 3; r++)
+        {
+            for (int d = -1; d <= 1; d++)
+            {
+                __m128i v = _mm_loadu_si128((const __m128i*)(rowPtrs[r] + j + d));
+
+                lo = _mm_add_epi32(lo, _mm_unpacklo_epi16(v, zero));
+                hi = _mm_add_epi32(hi, _mm_unpackhi_epi16(v, zero));
+            }
+        }
+
+        lo = _mm_sub_epi32(div9Epu32Sse2(lo), bias32);
+        hi = _mm_sub_epi32(div9Epu32Sse2(hi), bias32);
+
+        _mm_storeu_si128((__m128i*)(out + j), _mm_xor_si128(_mm_packs_epi32(lo, hi), bias16));
+    }
+
+    return j;
+}
+
+// AVX2 variants: unpack and pack both work within 128-bit lanes, so pixel order is preserved.
+__attribute__((target("avx2")))
+inline int blurSpanInteriorAvx2(const uint8_t* above, const uint8_t* cur, const uint8_t* below, uint8_t* out,
+                                int colBegin, int colEnd)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i inv9 = _mm256_set1_epi16(7282);
+    const uint8_t* rowPtrs[3] = {above, cur, below};
+
+    int j = colBegin;
+
+    for (; j + 32 <= colEnd; j += 32)
+    {
+        __m256i lo = zero, hi = zero;
+
+        for (int r = 0; r < 3; r++)
+        {
+            for (int d = -1; d <= 1; d++)
+            {
+                __m256i v = _mm256_loadu_si256((const __m256i*)(rowPtrs[r] + j + d));
+
+                lo = _mm256_add_epi16(lo, _mm256_unpacklo_epi8(v, zero));
+                hi = _mm256_add_epi16(hi, _mm256_unpackhi_epi8(v, zero));
+            }
+        }
+
+        lo = _mm256_mulhi_epu16(lo, inv9);
+        hi = _mm256_mulhi_epu16(hi, inv9);
+
+        _mm256_storeu_si256((__m256i*)(out + j), _mm256_packus_epi16(lo, hi));
+    }
+
+    return j;
+}
+
+__attribute__((target("avx2")))
+inline int blurSpanInteriorAvx2(const uint16_t* above, const uint16_t* cur, const uint16_t* below, uint16_t* out,
+                                int colBegin, int colEnd)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const uint16_t* rowPtrs[3] = {above, cur, below};
+
+    int j = colBegin;
+
+    for (; j + 16 <= colEnd; j += 16)
+    {
+        __m256i lo = zero, hi = zero;
+
+        for (int r = 0; r < 3; r++)
+        {
+            for (int d = -1; d <= 1; d++)
+            {
+                __m256i v = _mm256_loadu_si256((const __m256i*)(rowPtrs[r] + j + d));
+
+                lo = _mm256_add_epi32(lo, _mm256_unpacklo_epi16(v, zero));
+                hi = _mm256_add_epi32(hi, _mm256_unpackhi_epi16(v, zero));
+            }
+        }
+
+        lo = div9Epu32Avx2(lo);
+        hi = div9Epu32Avx2(hi);
+
+        _mm256_storeu_si256((__m256i*)(out + j), _mm256_packus_epi32(lo, hi));
+    }
+
+    return j;
+}
+
+#endif  // BLUR_HAVE_X86
+
+// Blurring one output row. above/below are null on the first/last image row, which
+// sends the whole row down the border path; otherwise only columns 0 and cols-1
+// (plus any tail the vector loop cannot cover) take the scalar border path.
+template <typename Pixel>
+void blurRow3x3(const Pixel* above, const Pixel* cur, const Pixel* below, Pixel* out, int cols, SimdLevel level)
+{
+    if (above == nullptr || below == nullptr || cols < 3)
+    {
+        blurSpanBorder(above, cur, below, out, cols, 0, cols);
+
+        return;
+    }
+
+    int j = 1;
+
+#if BLUR_HAVE_X86
+    if (level == SimdLevel::Avx2)
+        j = blurSpanInteriorAvx2(above, cur, below, out, j, cols - 1);
+    if (level != SimdLevel::Scalar)
+        j = blurSpanInteriorSse2(above, cur, below, out, j, cols - 1);
+#else
+    (void)level;
+#endif
+
+    blurSpanInteriorScalar(above, cur, below, out, j, cols - 1);
+
+    blurSpanBorder(above, cur, below, out, cols, 0, 1);
+    blurSpanBorder(above, cur, below, out, cols, cols - 1, cols);
+}
+
+// Sequential 3x3 blur of a whole 8/16-bit image
+template <typename Pixel>
+void boxBlurSimdSequential(const ImageBuffer<Pixel>& input, ImageBuffer<Pixel>& output, SimdLevel level)
+{
+    const int rows = input.rows;
+
+    for (int i = 0; i < rows; i++)
+    {
+        blurRow3x3(i > 0 ? input.row(i - 1) : nullptr, input.row(i),
+                   i < rows - 1 ? input.row(i + 1) : nullptr, output.row(i), input.cols, level);
+    }
+}
+
+// Parallel 3x3 blur of a whole 8/16-bit image, split by rows
+template <typename Pixel>
+void boxBlurSimdParallel(const ImageBuffer<Pixel>& input, ImageBuffer<Pixel>& output, SimdLevel level)
+{
+    const int rows = input.rows;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < rows; i++)
+    {
+        blurRow3x3(i > 0 ? input.row(i - 1) : nullptr, input.row(i),
+                   i < rows - 1 ? input.row(i + 1) : nullptr, output.row(i), input.cols, level);
+    }
+}
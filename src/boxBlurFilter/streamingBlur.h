@@ -0,0 +1,378 @@
+/********************************************************************
+ * File:        streamingBlur.h
+ *
+ * Description: Out-of-core 3x3 box blur for 8/16-bit binary PGM (P5) and
+ *              headerless raw images. The input is memory-mapped and cut
+ *              into row bands; every thread blurs one band at a time using
+ *              the halo row above and below it, and writes the result with
+ *              pwrite. Band height is derived from a memory budget so peak
+ *              RSS stays bounded regardless of the image size.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <omp.h>
+
+#include "simdBlur.h"
+
+struct ImageFileInfo
+{
+    int width = 0;
+    int height = 0;
+    int bytesPerPixel = 1;
+
+    bool bigEndian = false;  // 16-bit PGM samples are stored most significant byte first
+
+    size_t dataOffset = 0;   // Offset of the first pixel in the file
+};
+
+struct StreamingOptions
+{
+    std::string inputPath;
+    std::string outputPath;
+
+    // Raw input only (PGM carries its own header)
+    bool raw = false;
+    int rawWidth = 0;
+    int rawHeight = 0;
+    int rawDepth = 8;
+
+    size_t bandBudgetBytes = 64u << 20;  // Memory shared by all bands in flight
+
+    SimdLevel isa = SimdLevel::Scalar;
+};
+
+struct StreamingStats
+{
+    int width = 0;
+    int height = 0;
+    int bytesPerPixel = 1;
+    int bandRows = 0;
+    int bands = 0;
+    int threads = 0;
+
+    double seconds = 0.0;
+
+    long peakRssKb = 0;
+};
+
+// Parsing a binary PGM (P5) header, including '#' comments. Returns false on malformed input.
+inline bool parsePgmHeader(const unsigned char* data, size_t size, ImageFileInfo& info)
+{
+    size_t pos = 0;
+
+    auto skipSpaceAndComments = [&]() {
+        while (pos < size)
+        {
+            if (data[pos] == '#')
+            {
+                while (pos < size && data[pos] != '\n')
+                    pos++;
+            }
+            else if (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\r' || data[pos] == '\n')
+                pos++;
+            else
+                break;
+        }
+    };
+
+    auto readNumber = [&](long& value) {
+        skipSpaceAndComments();
+
+        if (pos >= size || data[pos] < '0' || data[pos] > '9')
+            return false;
+
+        value = 0;
+        while (pos < size && data[pos] >= '0' && data[pos] <= '9' && value < (1L << 31))
+            value = value * 10 + (data[pos++] - '0');
+
+        return true;
+    };
+
+    if (size < 2 || data[0] != 'P' || data[1] != '5')
+        return false;
+
+    pos = 2;
+
+    long width, height, maxValue;
+
+    if (!readNumber(width) || !readNumber(height) || !readNumber(maxValue))
+        return false;
+    if (width <= 0 || height <= 0 || width > INT32_MAX || height > INT32_MAX || maxValue <= 0 || maxValue > 65535)
+        return false;
+
+    // Exactly one whitespace byte separates the header from the samples
+    if (pos >= size)
+        return false;
+    pos++;
+
+    info.width = (int)width;
+    info.height = (int)height;
+    info.bytesPerPixel = maxValue > 255 ? 2 : 1;
+    info.bigEndian = info.bytesPerPixel == 2;
+    info.dataOffset = pos;
+
+    return true;
+}
+
+// Writing the whole buffer at the given offset, retrying short writes.
+inline bool pwriteAll(int fd, const void* buffer, size_t bytes, off_t offset)
+{
+    const char* p = (const char*)buffer;
+
+    while (bytes > 0)
+    {
+        ssize_t n = pwrite(fd, p, bytes, offset);
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        p += n;
+        bytes -= (size_t)n;
+        offset += n;
+    }
+
+    return true;
+}
+
+// Converting between file byte order and host uint16_t samples
+inline void loadSamples16(const unsigned char* src, uint16_t* dst, int count, bool bigEndian)
+{
+    if (bigEndian)
+    {
+        for (int j = 0; j < count; j++)
+            dst[j] = (uint16_t)((src[2 * j] << 8) | src[2 * j + 1]);
+    }
+    else
+        memcpy(dst, src, (size_t)count * 2);
+}
+
+inline void storeSamples16(const uint16_t* src, unsigned char* dst, int count, bool bigEndian)
+{
+    if (bigEndian)
+    {
+        for (int j = 0; j < count; j++)
+        {
+            dst[2 * j] = (unsigned char)(src[j] >> 8);
+            dst[2 * j + 1] = (unsigned char)(src[j] & 0xff);
+        }
+    }
+    else
+        memcpy(dst, src, (size_t)count * 2);
+}
+
+// Blurring one band [rowBegin, rowEnd) straight out of the mapping (8-bit) into out.
+inline void blurBand8(const unsigned char* pixels, size_t rowBytes, int width, int height,
+                      int rowBegin, int rowEnd, unsigned char* out, SimdLevel isa)
+{
+    for (int i = rowBegin; i < rowEnd; i++)
+    {
+        const uint8_t* cur = pixels + (size_t)i * rowBytes;
+
+        blurRow3x3<uint8_t>(i > 0 ? cur - rowBytes : nullptr, cur, i < height - 1 ? cur + rowBytes : nullptr,
+                            out + (size_t)(i - rowBegin) * rowBytes, width, isa);
+    }
+}
+
+// Blurring one 16-bit band. Rows (including halos) are first copied into host-order scratch,
+// which also removes any misalignment introduced by the PGM header.
+inline void blurBand16(const unsigned char* pixels, size_t rowBytes, int width, int height, bool bigEndian,
+                       int rowBegin, int rowEnd, std::vector<uint16_t>& scratch, std::vector<uint16_t>& result,
+                       unsigned char* out, SimdLevel isa)
+{
+    const int haloBegin = std::max(0, rowBegin - 1);
+    const int haloEnd = std::min(height, rowEnd + 1);
+
+    for (int i = haloBegin; i < haloEnd; i++)
+        loadSamples16(pixels + (size_t)i * rowBytes, scratch.data() + (size_t)(i - haloBegin) * width, width, bigEndian);
+
+    for (int i = rowBegin; i < rowEnd; i++)
+    {
+        const uint16_t* cur = scratch.data() + (size_t)(i - haloBegin) * width;
+
+        blurRow3x3<uint16_t>(i > 0 ? cur - width : nullptr, cur, i < height - 1 ? cur + width : nullptr,
+                             result.data(), width, isa);
+
+        storeSamples16(result.data(), out + (size_t)(i - rowBegin) * rowBytes, width, bigEndian);
+    }
+}
+
+// Streaming blur of inputPath into outputPath. On failure, error holds a message and false is returned.
+inline bool streamingBlur(const StreamingOptions& options, StreamingStats& stats, std::string& error)
+{
+    int inFd = open(options.inputPath.c_str(), O_RDONLY);
+
+    if (inFd < 0)
+    {
+        error = "cannot open " + options.inputPath + ": " + strerror(errno);
+
+        return false;
+    }
+
+    struct stat st;
+
+    if (fstat(inFd, &st) != 0 || st.st_size == 0)
+    {
+        error = "cannot stat " + options.inputPath;
+        close(inFd);
+
+        return false;
+    }
+
+    size_t fileSize = (size_t)st.st_size;
+    void* mapped = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, inFd, 0);
+
+    close(inFd);
+
+    if (mapped == MAP_FAILED)
+    {
+        error = "cannot map " + options.inputPath + ": " + strerror(errno);
+
+        return false;
+    }
+
+    const unsigned char* base = (const unsigned char*)mapped;
+    ImageFileInfo info;
+
+    if (options.raw)
+    {
+        info.width = options.rawWidth;
+        info.height = options.rawHeight;
+        info.bytesPerPixel = options.rawDepth == 16 ? 2 : 1;
+    }
+    else if (!parsePgmHeader(base, fileSize, info))
+    {
+        error = options.inputPath + " is not a binary (P5) PGM file";
+        munmap(mapped, fileSize);
+
+        return false;
+    }
+
+    const size_t rowBytes = (size_t)info.width * info.bytesPerPixel;
+    const size_t dataBytes = rowBytes * (size_t)info.height;
+
+    if (info.width <= 0 || info.height <= 0 || info.dataOffset + dataBytes > fileSize)
+    {
+        error = options.inputPath + " is shorter than its declared dimensions";
+        munmap(mapped, fileSize);
+
+        return false;
+    }
+
+    madvise(mapped, fileSize, MADV_SEQUENTIAL);
+
+    int outFd = open(options.outputPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (outFd < 0)
+    {
+        error = "cannot create " + options.outputPath + ": " + strerror(errno);
+        munmap(mapped, fileSize);
+
+        return false;
+    }
+
+    // Output keeps the input's header (PGM) or layout (raw)
+    bool ok = pwriteAll(outFd, base, info.dataOffset, 0) && ftruncate(outFd, (off_t)(info.dataOffset + dataBytes)) == 0;
+
+    // errno is per thread, so a failing band worker stores its own here for the message
+    int writeErrno = ok ? 0 : errno;
+
+    const unsigned char* pixels = base + info.dataOffset;
+    const int threads = omp_get_max_threads();
+
+    // Each band in flight holds its mapped input rows, its output rows and, for 16-bit, a host-order copy.
+    size_t perRow = rowBytes * (info.bytesPerPixel == 2 ? 3 : 2);
+    size_t budgetRows = options.bandBudgetBytes / std::max<size_t>(1, perRow * threads);
+    int bandRows = (int)std::max<size_t>(1, std::min<size_t>(budgetRows, (size_t)info.height));
+    int bands = (info.height + bandRows - 1) / bandRows;
+    long pageSize = sysconf(_SC_PAGESIZE);
+
+    double start = omp_get_wtime();
+
+    #pragma omp parallel if(ok)
+    {
+        std::vector<unsigned char> out((size_t)bandRows * rowBytes);
+        std::vector<uint16_t> scratch, result;
+
+        if (info.bytesPerPixel == 2)
+        {
+            scratch.resize((size_t)(bandRows + 2) * info.width);
+            result.resize(info.width);
+        }
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int b = 0; b < bands; b++)
+        {
+            int rowBegin = b * bandRows;
+            int rowEnd = std::min(info.height, rowBegin + bandRows);
+
+            if (info.bytesPerPixel == 1)
+                blurBand8(pixels, rowBytes, info.width, info.height, rowBegin, rowEnd, out.data(), options.isa);
+            else
+                blurBand16(pixels, rowBytes, info.width, info.height, info.bigEndian, rowBegin, rowEnd,
+                           scratch, result, out.data(), options.isa);
+
+            off_t offset = (off_t)(info.dataOffset + (size_t)rowBegin * rowBytes);
+
+            if (!pwriteAll(outFd, out.data(), (size_t)(rowEnd - rowBegin) * rowBytes, offset))
+            {
+                int failure = errno;
+
+                #pragma omp atomic write
+                writeErrno = failure;
+
+                #pragma omp atomic write
+                ok = false;
+            }
+
+            // Dropping this band's input pages from the mapping; a neighbor that still needs a
+            // halo row simply faults it back in from the file.
+            size_t first = info.dataOffset + (size_t)rowBegin * rowBytes;
+            size_t last = info.dataOffset + (size_t)rowEnd * rowBytes;
+            size_t alignedFirst = (first + pageSize - 1) / pageSize * pageSize;
+            size_t alignedLast = last / pageSize * pageSize;
+
+            if (alignedLast > alignedFirst)
+                madvise((char*)mapped + alignedFirst, alignedLast - alignedFirst, MADV_DONTNEED);
+        }
+    }
+
+    double end = omp_get_wtime();
+
+    if (!ok)
+        error = "write to " + options.outputPath + " failed: " + strerror(writeErrno);
+
+    close(outFd);
+    munmap(mapped, fileSize);
+
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    stats.width = info.width;
+    stats.height = info.height;
+    stats.bytesPerPixel = info.bytesPerPixel;
+    stats.bandRows = bandRows;
+    stats.bands = bands;
+    stats.threads = threads;
+    stats.seconds = end - start;
+    stats.peakRssKb = usage.ru_maxrss;
+
+    return ok;
+}
@@ -0,0 +1,318 @@
+/********************************************************************
+ * File:        autotuner.h
+ *
+ * Description: Autotuning layer shared by the simulations. A kernel
+ *              offers a list of candidate configurations (kernel variant,
+ *              OpenMP schedule kind and chunk, thread count, tile size) and
+ *              a function that runs a representative slice of the problem
+ *              with one of them; the tuner times every candidate and keeps
+ *              the fastest. Winners are cached in a local text file keyed
+ *              by (kernel, problem size, CPU model, thread budget), so later
+ *              runs on the same machine reuse them without measuring;
+ *              --retune forces a new search.
+ *
+ *              Loops that take a tuned schedule use schedule(runtime), and
+ *              applyTuning() sets it through omp_set_schedule.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+struct TuningConfig
+{
+    std::string variant = "default";  // Kernel variant, named by the kernel
+    omp_sched_t schedule = omp_sched_static;
+    int chunk = 0;    // 0: the schedule's default chunk
+    int threads = 0;  // 0: all available threads
+    int tile = 0;     // 0: not used by the variant
+};
+
+struct AutotuneOptions
+{
+    bool enabled = false;
+    bool retune = false;  // Ignore cached winners and measure again
+
+    std::string cachePath = "autotune.cache";
+
+    int repetitions = 3;  // Timed runs per candidate (the fastest counts), after one warmup
+};
+
+// Consuming one autotuning option at argv[a]; returns false if argv[a] is not one.
+inline bool parseAutotuneOption(int& a, int argc, char* argv[], AutotuneOptions& options)
+{
+    std::string arg = argv[a];
+
+    if (arg == "--autotune")
+        options.enabled = true;
+    else if (arg == "--retune")
+        options.enabled = options.retune = true;
+    else if (arg == "--tune-cache" && a + 1 < argc)
+        options.cachePath = argv[++a];
+    else if (arg == "--tune-reps" && a + 1 < argc)
+        options.repetitions = std::max(1, atoi(argv[++a]));
+    else
+        return false;
+
+    return true;
+}
+
+inline const char* autotuneUsage()
+{
+    return "[--autotune] [--retune] [--tune-cache FILE] [--tune-reps N]";
+}
+
+inline const char* scheduleName(omp_sched_t kind)
+{
+    switch ((int)kind & ~(int)omp_sched_monotonic)
+    {
+        case omp_sched_static:
+            return "static";
+        case omp_sched_dynamic:
+            return "dynamic";
+        case omp_sched_guided:
+            return "guided";
+        default:
+            return "auto";
+    }
+}
+
+inline omp_sched_t parseScheduleName(const std::string& name)
+{
+    if (name == "dynamic")
+        return omp_sched_dynamic;
+    if (name == "guided")
+        return omp_sched_guided;
+    if (name == "auto")
+        return omp_sched_auto;
+
+    return omp_sched_static;
+}
+
+// "variant schedule,chunk threads=T tile=S" for reports
+inline std::string describeTuning(const TuningConfig& config)
+{
+    std::ostringstream out;
+
+    out << config.variant << " " << scheduleName(config.schedule);
+
+    if (config.chunk > 0)
+        out << "," << config.chunk;
+
+    out << " threads=" << (config.threads > 0 ? config.threads : omp_get_max_threads());
+
+    if (config.tile > 0)
+        out << " tile=" << config.tile;
+
+    return out.str();
+}
+
+// Setting the schedule used by schedule(runtime) loops and the team size of the next parallel regions.
+inline void applyTuning(const TuningConfig& config)
+{
+    omp_set_schedule(config.schedule, config.chunk);
+
+    if (config.threads > 0)
+        omp_set_num_threads(config.threads);
+}
+
+// schedule(runtime) defaults to dynamic,1 in libgomp; loops that used to be schedule(static) keep
+// that default unless OMP_SCHEDULE says otherwise. Call once at startup.
+inline void initRuntimeSchedule()
+{
+    if (getenv("OMP_SCHEDULE") == NULL)
+        omp_set_schedule(omp_sched_static, 0);
+}
+
+// CPU model from /proc/cpuinfo, with spaces replaced so it fits in one cache field.
+inline std::string cpuModelName()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+
+    while (std::getline(cpuinfo, line))
+    {
+        if (line.compare(0, 10, "model name") == 0)
+        {
+            std::string model = line.substr(line.find(':') + 1);
+
+            model.erase(0, model.find_first_not_of(' '));
+
+            for (char& ch : model)
+            {
+                if (ch == ' ' || ch == '\t' || ch == '|')
+                    ch = '_';
+            }
+
+            return model;
+        }
+    }
+
+    return "unknown-cpu";
+}
+
+// 1, 2, 4, ... up to the thread budget (always including the budget itself).
+inline std::vector<int> threadCandidates(int budget)
+{
+    std::vector<int> counts;
+
+    for (int t = 1; t < budget; t *= 2)
+        counts.push_back(t);
+
+    counts.push_back(budget);
+
+    return counts;
+}
+
+class Autotuner
+{
+public:
+    explicit Autotuner(const AutotuneOptions& tuneOptions)
+        : options(tuneOptions), cpuModel(cpuModelName()), threadBudget(omp_get_max_threads())
+    {
+        load();
+    }
+
+    int getThreadBudget() const { return threadBudget; }
+
+    // Returning the cached winner for (kernel, size), or timing every candidate with run and caching
+    // the fastest. Progress goes to log (if not null).
+    TuningConfig select(const std::string& kernel, const std::string& size, const std::vector<TuningConfig>& candidates,
+                        const std::function<void(const TuningConfig&)>& run, std::ostream* log)
+    {
+        const std::string key = kernel + "|" + size + "|" + cpuModel + "|" + std::to_string(threadBudget);
+
+        auto cached = entries.find(key);
+
+        if (cached != entries.end() && !options.retune)
+        {
+            lastFromCache = true;
+            lastSeconds = cached->second.seconds;
+
+            return cached->second.config;
+        }
+
+        lastFromCache = false;
+
+        TuningConfig best = candidates.empty() ? TuningConfig() : candidates[0];
+        double bestSeconds = -1;
+
+        for (const TuningConfig& candidate : candidates)
+        {
+            applyTuning(candidate);
+
+            run(candidate);  // Warmup
+
+            double fastest = -1;
+
+            for (int r = 0; r < options.repetitions; r++)
+            {
+                double start = omp_get_wtime();
+
+                run(candidate);
+
+                double seconds = omp_get_wtime() - start;
+
+                if (fastest < 0 || seconds < fastest)
+                    fastest = seconds;
+            }
+
+            if (log)
+                *log << "   tune " << kernel << " " << size << ": " << describeTuning(candidate) << " -> " << fastest << " s" << std::endl;
+
+            if (bestSeconds < 0 || fastest < bestSeconds)
+            {
+                bestSeconds = fastest;
+                best = candidate;
+            }
+        }
+
+        // Leaving the runtime as it was before tuning
+        omp_set_num_threads(threadBudget);
+        initRuntimeSchedule();
+
+        entries[key] = Entry{best, bestSeconds};
+        lastSeconds = bestSeconds;
+
+        if (!save() && log)
+            *log << "   (could not write " << options.cachePath << ")" << std::endl;
+
+        return best;
+    }
+
+    bool wasCached() const { return lastFromCache; }
+    double sliceSeconds() const { return lastSeconds; }
+
+private:
+    struct Entry
+    {
+        TuningConfig config;
+
+        double seconds = 0;  // Slice time of the winner when it was measured
+    };
+
+    AutotuneOptions options;
+
+    std::string cpuModel;
+
+    int threadBudget;
+
+    std::map<std::string, Entry> entries;
+
+    bool lastFromCache = false;
+    double lastSeconds = 0;
+
+    // Cache lines: key <TAB> variant <TAB> schedule <TAB> chunk <TAB> threads <TAB> tile <TAB> seconds
+    void load()
+    {
+        std::ifstream in(options.cachePath);
+        std::string line;
+
+        while (std::getline(in, line))
+        {
+            std::istringstream fields(line);
+            std::string key, variant, schedule;
+            Entry entry;
+
+            if (std::getline(fields, key, '\t') && std::getline(fields, variant, '\t') && std::getline(fields, schedule, '\t')
+                && fields >> entry.config.chunk >> entry.config.threads >> entry.config.tile >> entry.seconds)
+            {
+                entry.config.variant = variant;
+                entry.config.schedule = parseScheduleName(schedule);
+                entries[key] = entry;
+            }
+        }
+    }
+
+    bool save() const
+    {
+        std::string temporary = options.cachePath + ".tmp";
+
+        {
+            std::ofstream out(temporary);
+
+            for (const auto& item : entries)
+            {
+                const TuningConfig& c = item.second.config;
+
+                out << item.first << "\t" << c.variant << "\t" << scheduleName(c.schedule) << "\t" << c.chunk << "\t"
+                    << c.threads << "\t" << c.tile << "\t" << item.second.seconds << "\n";
+            }
+
+            if (!out)
+                return false;
+        }
+
+        return rename(temporary.c_str(), options.cachePath.c_str()) == 0;
+    }
+};
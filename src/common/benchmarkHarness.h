@@ -0,0 +1,307 @@
+/********************************************************************
+ * File:        benchmarkHarness.h
+ *
+ * Description: Shared benchmark harness for the three simulations. Each
+ *              program registers its variants as BenchmarkCase entries;
+ *              the harness runs warmups and timed repetitions for every
+ *              thread count in the sweep, checks the output against the
+ *              serial implementation and reports min/median/p95 times and
+ *              throughput as a text table, CSV or JSON.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+struct BenchmarkConfig
+{
+    int warmup = 1;
+    int repetitions = 5;
+
+    std::vector<int> threads;   // Thread counts for parallel variants (empty: 1, 2, 4, ... up to the core count)
+
+    std::string format = "text";  // text | csv | json
+    std::string outputPath;       // Empty: standard output
+
+    bool verify = true;
+};
+
+struct BenchmarkCase
+{
+    std::string benchmark;  // Program, e.g. "boxBlur"
+    std::string variant;    // Implementation, e.g. "parallel"
+    std::string size;       // Problem size label, e.g. "1000x1000"
+    std::string unit;       // Work unit for throughput, e.g. "pixels"
+
+    bool parallel = true;   // Serial variants run once with one thread instead of the sweep
+
+    std::function<void()> setup;    // Untimed, before every run
+    std::function<double()> run;    // Timed; returns the number of work units processed
+    std::function<bool()> verify;   // Optional; checks the output of the last run
+};
+
+struct BenchmarkResult
+{
+    std::string benchmark, variant, size, unit, verified;
+
+    int threads = 1;
+    int repetitions = 0;
+
+    double minSeconds = 0, medianSeconds = 0, p95Seconds = 0, meanSeconds = 0;
+    double work = 0;  // Work units per run (mean)
+};
+
+// Consuming one --bench-* option at argv[a]. Returns false if argv[a] is not a harness option
+// (or its value is invalid); on success a points at the last consumed argument.
+inline bool parseBenchmarkOption(int& a, int argc, char* argv[], BenchmarkConfig& config)
+{
+    std::string arg = argv[a];
+
+    if (a + 1 >= argc)
+        return false;
+
+    if (arg == "--bench-warmup")
+        config.warmup = atoi(argv[++a]);
+    else if (arg == "--bench-reps")
+        config.repetitions = atoi(argv[++a]);
+    else if (arg == "--bench-threads")
+    {
+        config.threads.clear();
+
+        std::stringstream list(argv[++a]);
+        std::string item;
+
+        while (std::getline(list, item, ','))
+        {
+            int t = atoi(item.c_str());
+
+            if (t <= 0)
+                return false;
+
+            config.threads.push_back(t);
+        }
+    }
+    else if (arg == "--bench-format")
+    {
+        config.format = argv[++a];
+
+        if (config.format != "text" && config.format != "csv" && config.format != "json")
+            return false;
+    }
+    else if (arg == "--bench-output")
+        config.outputPath = argv[++a];
+    else if (arg == "--bench-verify")
+        config.verify = atoi(argv[++a]) != 0;
+    else
+        return false;
+
+    return config.warmup >= 0 && config.repetitions > 0;
+}
+
+inline const char* benchmarkUsage()
+{
+    return "[--bench-warmup W] [--bench-reps N] [--bench-threads T1,T2,...] [--bench-format text|csv|json]"
+           " [--bench-output FILE] [--bench-verify 0|1]";
+}
+
+class BenchmarkHarness
+{
+public:
+    explicit BenchmarkHarness(const BenchmarkConfig& config) : config(config) {}
+
+    void add(const BenchmarkCase& benchmarkCase)
+    {
+        cases.push_back(benchmarkCase);
+    }
+
+    // Running every registered case; returns false if any verification failed.
+    bool run()
+    {
+        std::vector<int> sweep = config.threads;
+
+        if (sweep.empty())
+        {
+            for (int t = 1; t < omp_get_num_procs(); t *= 2)
+                sweep.push_back(t);
+
+            sweep.push_back(omp_get_num_procs());
+        }
+
+        bool allPassed = true;
+
+        for (const BenchmarkCase& c : cases)
+        {
+            std::vector<int> threadCounts = c.parallel ? sweep : std::vector<int>{1};
+
+            for (int threads : threadCounts)
+            {
+                BenchmarkResult result = measure(c, threads);
+
+                if (result.verified == "FAIL")
+                    allPassed = false;
+
+                // Progress goes to stderr so machine-readable stdout stays clean
+                std::cerr << "-> " << c.benchmark << "/" << c.variant << " " << c.size << " threads=" << threads
+                          << " median=" << result.medianSeconds << "s verify=" << result.verified << std::endl;
+
+                results.push_back(result);
+            }
+        }
+
+        return allPassed;
+    }
+
+    void report() const
+    {
+        std::ofstream file;
+
+        if (!config.outputPath.empty())
+            file.open(config.outputPath);
+
+        std::ostream& out = config.outputPath.empty() ? std::cout : file;
+
+        if (config.format == "csv")
+            reportCsv(out);
+        else if (config.format == "json")
+            reportJson(out);
+        else
+            reportText(out);
+    }
+
+    const std::vector<BenchmarkResult>& getResults() const { return results; }
+
+private:
+    BenchmarkConfig config;
+
+    std::vector<BenchmarkCase> cases;
+    std::vector<BenchmarkResult> results;
+
+    BenchmarkResult measure(const BenchmarkCase& c, int threads)
+    {
+        int previousThreads = omp_get_max_threads();
+
+        // Setting the team size outside the timed region
+        omp_set_num_threads(threads);
+
+        for (int w = 0; w < config.warmup; w++)
+        {
+            if (c.setup)
+                c.setup();
+
+            c.run();
+        }
+
+        std::vector<double> times;
+        double work = 0;
+
+        for (int r = 0; r < config.repetitions; r++)
+        {
+            if (c.setup)
+                c.setup();
+
+            double start = omp_get_wtime();
+
+            work += c.run();
+
+            double end = omp_get_wtime();
+
+            times.push_back(end - start);
+        }
+
+        std::sort(times.begin(), times.end());
+
+        BenchmarkResult result;
+
+        result.benchmark = c.benchmark;
+        result.variant = c.variant;
+        result.size = c.size;
+        result.unit = c.unit;
+        result.threads = threads;
+        result.repetitions = config.repetitions;
+        result.minSeconds = times.front();
+        result.medianSeconds = times.size() % 2 ? times[times.size() / 2]
+                                                : 0.5 * (times[times.size() / 2 - 1] + times[times.size() / 2]);
+        result.p95Seconds = times[std::min(times.size() - 1, (size_t)(0.95 * times.size() + 0.999999) - 1)];
+
+        double total = 0;
+
+        for (double t : times)
+            total += t;
+
+        result.meanSeconds = total / times.size();
+        result.work = work / config.repetitions;
+
+        if (!config.verify || !c.verify)
+            result.verified = "n/a";
+        else
+            result.verified = c.verify() ? "pass" : "FAIL";
+
+        omp_set_num_threads(previousThreads);
+
+        return result;
+    }
+
+    static double throughput(const BenchmarkResult& r)
+    {
+        return r.medianSeconds > 0 ? r.work / r.medianSeconds : 0.0;
+    }
+
+    void reportText(std::ostream& out) const
+    {
+        char line[256];
+
+        snprintf(line, sizeof(line), "%-12s %-16s %-12s %7s %12s %12s %12s %14s %-14s %s\n", "benchmark", "variant",
+                 "size", "threads", "min(s)", "median(s)", "p95(s)", "throughput", "unit/s", "verify");
+        out << line;
+
+        for (const BenchmarkResult& r : results)
+        {
+            snprintf(line, sizeof(line), "%-12s %-16s %-12s %7d %12.6f %12.6f %12.6f %14.4g %-14s %s\n",
+                     r.benchmark.c_str(), r.variant.c_str(), r.size.c_str(), r.threads, r.minSeconds,
+                     r.medianSeconds, r.p95Seconds, throughput(r), r.unit.c_str(), r.verified.c_str());
+            out << line;
+        }
+    }
+
+    void reportCsv(std::ostream& out) const
+    {
+        out << "benchmark,variant,size,threads,repetitions,min_s,median_s,p95_s,mean_s,work,unit,work_per_s,verified\n";
+
+        for (const BenchmarkResult& r : results)
+        {
+            out << r.benchmark << "," << r.variant << "," << r.size << "," << r.threads << "," << r.repetitions << ","
+                << r.minSeconds << "," << r.medianSeconds << "," << r.p95Seconds << "," << r.meanSeconds << ","
+                << r.work << "," << r.unit << "," << throughput(r) << "," << r.verified << "\n";
+        }
+    }
+
+    void reportJson(std::ostream& out) const
+    {
+        out << "[\n";
+
+        for (size_t k = 0; k < results.size(); k++)
+        {
+            const BenchmarkResult& r = results[k];
+
+            out << "  {\"benchmark\": \"" << r.benchmark << "\", \"variant\": \"" << r.variant
+                << "\", \"size\": \"" << r.size << "\", \"threads\": " << r.threads
+                << ", \"repetitions\": " << r.repetitions << ", \"min_s\": " << r.minSeconds
+                << ", \"median_s\": " << r.medianSeconds << ", \"p95_s\": " << r.p95Seconds
+                << ", \"mean_s\": " << r.meanSeconds << ", \"work\": " << r.work << ", \"unit\": \"" << r.unit
+                << "\", \"work_per_s\": " << throughput(r) << ", \"verified\": \"" << r.verified << "\"}"
+                << (k + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "]\n";
+    }
+};
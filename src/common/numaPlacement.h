@@ -0,0 +1,138 @@
+/********************************************************************
+ * File:        numaPlacement.h
+ *
+ * Description: NUMA helpers for the grid workloads. Grids are allocated
+ *              row by row inside a parallel loop that uses the same static
+ *              partitioning as the compute loop, so each row's pages are
+ *              first touched (and placed) on the node of the thread that
+ *              will later work on it. OMP_PLACES / OMP_PROC_BIND can be set
+ *              from the command line, and the resulting thread-to-core
+ *              placement can be printed.
+ ********************************************************************/
+
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include <unistd.h>
+#include <omp.h>
+
+struct PlacementConfig
+{
+    std::string places;  // OMP_PLACES, e.g. "cores", "sockets", "{0:8},{8:8}"
+    std::string bind;    // OMP_PROC_BIND, e.g. "close", "spread", "master"
+
+    bool report = false;
+};
+
+// Consuming one placement option at argv[a]; returns false if argv[a] is not one.
+inline bool parsePlacementOption(int& a, int argc, char* argv[], PlacementConfig& config)
+{
+    std::string arg = argv[a];
+
+    if (arg == "--placement")
+        config.report = true;
+    else if (arg == "--places" && a + 1 < argc)
+        config.places = argv[++a];
+    else if (arg == "--bind" && a + 1 < argc)
+        config.bind = argv[++a];
+    else
+        return false;
+
+    return true;
+}
+
+inline const char* placementUsage()
+{
+    return "[--places cores|threads|sockets|LIST] [--bind close|spread|master] [--placement]";
+}
+
+// The OpenMP runtime reads OMP_PLACES / OMP_PROC_BIND once at startup, so changing them from the
+// command line means re-executing the program with the new environment. Call this before any
+// parallel region. Returns only if no re-exec was needed (or it failed).
+inline void applyPlacement(const PlacementConfig& config, char* argv[])
+{
+    bool changed = false;
+
+    auto update = [&](const char* name, const std::string& value) {
+        const char* current = getenv(name);
+
+        if (!value.empty() && (current == NULL || value != current))
+        {
+            setenv(name, value.c_str(), 1);
+
+            changed = true;
+        }
+    };
+
+    update("OMP_PLACES", config.places);
+    update("OMP_PROC_BIND", config.bind);
+
+    if (changed)
+    {
+        execv("/proc/self/exe", argv);
+
+        std::cerr << "Warning: could not restart with the new OpenMP placement; continuing with the old one." << std::endl;
+    }
+}
+
+// Printing which place, CPU and NUMA node every thread of a default-sized team runs on.
+inline void reportThreadPlacement(std::ostream& out)
+{
+    int threads = omp_get_max_threads();
+
+    std::vector<int> places(threads, -1), cpus(threads, -1), nodes(threads, -1);
+
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        unsigned cpu = 0, node = 0;
+
+        places[tid] = omp_get_place_num();
+
+        if (getcpu(&cpu, &node) == 0)
+        {
+            cpus[tid] = (int)cpu;
+            nodes[tid] = (int)node;
+        }
+    }
+
+    const char* bindNames[] = {"false", "true", "master", "close", "spread"};
+    int bind = (int)omp_get_proc_bind();
+
+    out << "> Thread placement (" << omp_get_num_places() << " places, proc_bind "
+        << (bind >= 0 && bind < 5 ? bindNames[bind] : "?") << "):" << std::endl;
+
+    for (int t = 0; t < threads; t++)
+    {
+        out << "-> Thread " << t << ": place " << places[t] << ", cpu " << cpus[t] << ", node " << nodes[t] << std::endl;
+    }
+
+    out << std::endl;
+}
+
+// Allocating a rows x cols grid whose rows are first touched by the threads that own them under
+// schedule(static, chunk) (chunk <= 0 means plain schedule(static)).
+template <typename T>
+std::vector<std::vector<T>> makeFirstTouchGrid(int rows, int cols, T value, int chunk = 0)
+{
+    std::vector<std::vector<T>> grid(rows);
+
+    if (chunk > 0)
+    {
+        #pragma omp parallel for schedule(static, chunk)
+        for (int i = 0; i < rows; i++)
+            grid[i].assign(cols, value);
+    }
+    else
+    {
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < rows; i++)
+            grid[i].assign(cols, value);
+    }
+
+    return grid;
+}
@@ -0,0 +1,196 @@
+/********************************************************************
+ * File:        bitLife.h
+ *
+ * Description: Bit-packed Game of Life engine. Each row is stored as
+ *              64-cell uint64_t words and all 64 next states of a word are
+ *              computed at once by adding the eight shifted neighbor words
+ *              with bitwise full adders (SWAR). Boundaries are toroidal,
+ *              including grids whose width is not a multiple of 64.
+ ********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <omp.h>
+
+struct BitGrid
+{
+    int rows = 0;
+    int cols = 0;
+    int wordsPerRow = 0;
+    int lastBits = 64;         // Valid bits in the last word of every row
+
+    uint64_t lastMask = ~0ULL;
+
+    std::unique_ptr<uint64_t[]> words;  // Left uninitialized by new[] so clear() does the first touch
+
+    BitGrid() = default;
+
+    BitGrid(int r, int c)
+    {
+        rows = r;
+        cols = c;
+        wordsPerRow = (c + 63) / 64;
+        lastBits = c - 64 * (wordsPerRow - 1);
+        lastMask = lastBits == 64 ? ~0ULL : ((1ULL << lastBits) - 1);
+        words.reset(new uint64_t[(size_t)rows * wordsPerRow]);
+
+        clear();
+    }
+
+    // Zeroing the grid with the same static row split the step kernel uses (NUMA first touch)
+    void clear()
+    {
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < rows; i++)
+            memset(row(i), 0, (size_t)wordsPerRow * sizeof(uint64_t));
+    }
+
+    uint64_t* row(int i) { return words.get() + (size_t)i * wordsPerRow; }
+    const uint64_t* row(int i) const { return words.get() + (size_t)i * wordsPerRow; }
+
+    bool get(int i, int j) const { return (row(i)[j >> 6] >> (j & 63)) & 1; }
+
+    void set(int i, int j, bool alive)
+    {
+        uint64_t bit = 1ULL << (j & 63);
+
+        if (alive)
+            row(i)[j >> 6] |= bit;
+        else
+            row(i)[j >> 6] &= ~bit;
+    }
+};
+
+// Word w of the row shifted so that bit j holds the cell to the east (column j+1, wrapping).
+inline uint64_t eastWord(const uint64_t* row, int w, const BitGrid& g)
+{
+    if (w < g.wordsPerRow - 1)
+        return (row[w] >> 1) | (row[w + 1] << 63);
+
+    return (row[w] >> 1) | ((row[0] & 1) << (g.lastBits - 1));
+}
+
+// Word w of the row shifted so that bit j holds the cell to the west (column j-1, wrapping).
+inline uint64_t westWord(const uint64_t* row, int w, const BitGrid& g)
+{
+    uint64_t x;
+
+    if (w > 0)
+        x = (row[w] << 1) | (row[w - 1] >> 63);
+    else
+        x = (row[0] << 1) | ((row[g.wordsPerRow - 1] >> (g.lastBits - 1)) & 1);
+
+    return w == g.wordsPerRow - 1 ? (x & g.lastMask) : x;
+}
+
+// Next state of 64 cells from their eight neighbor words, using full adders on bit planes.
+inline uint64_t lifeWord(uint64_t alive,
+                         uint64_t nw, uint64_t n, uint64_t ne,
+                         uint64_t w, uint64_t e,
+                         uint64_t sw, uint64_t s, uint64_t se)
+{
+    // Three groups -> (ones, twos) pairs
+    uint64_t onesA = nw ^ n ^ ne;
+    uint64_t twosA = (nw & n) | (ne & (nw ^ n));
+    uint64_t onesB = w ^ e ^ sw;
+    uint64_t twosB = (w & e) | (sw & (w ^ e));
+    uint64_t onesC = s ^ se;
+    uint64_t twosC = s & se;
+
+    // Ones column
+    uint64_t ones = onesA ^ onesB ^ onesC;
+    uint64_t twosD = (onesA & onesB) | (onesC & (onesA ^ onesB));
+
+    // Twos column: four weight-2 inputs; any pair of them carries into the fours
+    uint64_t twosE = twosA ^ twosB ^ twosC;
+    uint64_t foursA = (twosA & twosB) | (twosC & (twosA ^ twosB));
+    uint64_t twos = twosE ^ twosD;
+    uint64_t foursB = twosE & twosD;
+
+    // Alive next: count is 3, or count is 2 and the cell is alive
+    return twos & ~(foursA | foursB) & (ones | alive);
+}
+
+// One generation: next = step(current). Rows are split statically across threads.
+inline void bitLifeStep(const BitGrid& current, BitGrid& next)
+{
+    const int rows = current.rows;
+    const int words = current.wordsPerRow;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < rows; i++)
+    {
+        const uint64_t* up = current.row((i + rows - 1) % rows);
+        const uint64_t* mid = current.row(i);
+        const uint64_t* down = current.row((i + 1) % rows);
+
+        uint64_t* out = next.row(i);
+
+        for (int w = 0; w < words; w++)
+        {
+            out[w] = lifeWord(mid[w],
+                              westWord(up, w, current), up[w], eastWord(up, w, current),
+                              westWord(mid, w, current), eastWord(mid, w, current),
+                              westWord(down, w, current), down[w], eastWord(down, w, current));
+        }
+    }
+}
+
+// Called after every generation with the grid and the generations done; returning true ends the run
+// with grid (which the callback may replace) as its result.
+typedef std::function<bool(BitGrid& grid, int gen)> BitSyncHook;
+
+// Advancing the grid by the given number of generations (the result is left in grid).
+inline void bitLifeRun(BitGrid& grid, int generations, const BitSyncHook& afterGeneration = nullptr)
+{
+    BitGrid scratch(grid.rows, grid.cols);
+
+    for (int gen = 0; gen < generations; gen++)
+    {
+        bitLifeStep(grid, scratch);
+
+        std::swap(grid.words, scratch.words);
+
+        if (afterGeneration && afterGeneration(grid, gen + 1))
+            break;
+    }
+}
+
+// Conversions to and from the '*' / '.' char grid used by the other versions
+inline BitGrid packGrid(const std::vector<std::vector<char>>& grid)
+{
+    BitGrid packed((int)grid.size(), grid.empty() ? 0 : (int)grid[0].size());
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < packed.rows; i++)
+    {
+        for (int j = 0; j < packed.cols; j++)
+        {
+            if (grid[i][j] == '*')
+                packed.set(i, j, true);
+        }
+    }
+
+    return packed;
+}
+
+inline std::vector<std::vector<char>> unpackGrid(const BitGrid& packed)
+{
+    std::vector<std::vector<char>> grid(packed.rows, std::vector<char>(packed.cols, '.'));
+
+    for (int i = 0; i < packed.rows; i++)
+    {
+        for (int j = 0; j < packed.cols; j++)
+        {
+            if (packed.get(i, j))
+                grid[i][j] = '*';
+        }
+    }
+
+    return grid;
+}
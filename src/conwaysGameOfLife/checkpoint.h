@@ -0,0 +1,448 @@
+/********************************************************************
+ * File:        checkpoint.h
+ *
+ * Description: Asynchronous checkpoint / restart for the Life grid. A
+ *              snapshot is bit-packed (8 cells per byte) by the compute
+ *              thread into a spare buffer and handed to a background
+ *              writer by swapping buffers, so the compute loop only pays
+ *              for the packing. The writer compresses the packed rows with
+ *              a PackBits-style run-length code (Life grids are mostly
+ *              empty), adds a CRC-32 and replaces the checkpoint file
+ *              atomically (write to a temporary file, then rename). If a
+ *              new snapshot arrives while the previous one is still
+ *              waiting, the older one is superseded rather than queued.
+ *
+ *              File layout (little-endian):
+ *                "LIFECKP1" | rows u32 | cols u32 | generation u64 |
+ *                packed bytes u64 | compressed bytes u64 | crc32 u32 |
+ *                compressed payload
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+#include "bitLife.h"
+#include "lifeGrid.h"
+
+struct CheckpointStats
+{
+    long written = 0;
+    long superseded = 0;      // Snapshots replaced by a newer one before the writer got to them
+    long failed = 0;
+
+    uint64_t lastGeneration = 0;
+    size_t lastRawBytes = 0;        // Bit-packed size of the last snapshot
+    size_t lastCompressedBytes = 0;
+
+    double packSeconds = 0;   // Spent on the compute thread
+    double writeSeconds = 0;  // Spent on the background writer
+};
+
+inline uint32_t crc32(const uint8_t* data, size_t bytes)
+{
+    static const std::vector<uint32_t> table = [] {
+        std::vector<uint32_t> t(256);
+
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+
+            t[n] = c;
+        }
+
+        return t;
+    }();
+
+    uint32_t c = 0xFFFFFFFFu;
+
+    for (size_t i = 0; i < bytes; i++)
+        c = table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+
+    return c ^ 0xFFFFFFFFu;
+}
+
+// PackBits-style coding: a control byte n < 128 is followed by n + 1 literal bytes,
+// n >= 128 by one byte repeated n - 125 times (3..130).
+inline void compressRuns(const std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+{
+    out.clear();
+
+    size_t i = 0, literalStart = 0;
+
+    auto flushLiterals = [&](size_t end) {
+        while (literalStart < end)
+        {
+            size_t n = std::min<size_t>(128, end - literalStart);
+
+            out.push_back((uint8_t)(n - 1));
+            out.insert(out.end(), in.begin() + literalStart, in.begin() + literalStart + n);
+            literalStart += n;
+        }
+    };
+
+    while (i < in.size())
+    {
+        size_t run = 1;
+
+        while (i + run < in.size() && run < 130 && in[i + run] == in[i])
+            run++;
+
+        if (run >= 3)
+        {
+            flushLiterals(i);
+            out.push_back((uint8_t)(run + 125));
+            out.push_back(in[i]);
+            i += run;
+            literalStart = i;
+        }
+        else
+            i += run;
+    }
+
+    flushLiterals(in.size());
+}
+
+inline bool expandRuns(const uint8_t* in, size_t bytes, std::vector<uint8_t>& out, size_t expected)
+{
+    out.clear();
+    out.reserve(expected);
+
+    size_t i = 0;
+
+    while (i < bytes)
+    {
+        uint8_t control = in[i++];
+
+        if (control < 128)
+        {
+            size_t n = (size_t)control + 1;
+
+            if (i + n > bytes)
+                return false;
+
+            out.insert(out.end(), in + i, in + i + n);
+            i += n;
+        }
+        else
+        {
+            if (i >= bytes)
+                return false;
+
+            out.insert(out.end(), (size_t)control - 125, in[i++]);
+        }
+
+        if (out.size() > expected)
+            return false;
+    }
+
+    return out.size() == expected;
+}
+
+inline size_t packedRowBytes(int cols) { return (size_t)(cols + 7) / 8; }
+
+// Header after the magic: rows, cols (u32), generation, packed bytes, compressed bytes (u64), crc32 (u32).
+constexpr size_t CHECKPOINT_HEADER_BYTES = 4 + 4 + 8 + 8 + 8 + 4;
+
+// Storing the low bytes of value least significant first (little-endian whatever the host order).
+inline uint8_t* putLittle(uint8_t* out, uint64_t value, int bytes)
+{
+    for (int k = 0; k < bytes; k++)
+        out[k] = (uint8_t)(value >> (8 * k));
+
+    return out + bytes;
+}
+
+inline const uint8_t* getLittle(const uint8_t* in, uint64_t& value, int bytes)
+{
+    value = 0;
+
+    for (int k = 0; k < bytes; k++)
+        value |= (uint64_t)in[k] << (8 * k);
+
+    return in + bytes;
+}
+
+class Checkpointer
+{
+public:
+    explicit Checkpointer(const std::string& filePath) : path(filePath), writer(&Checkpointer::writerLoop, this) {}
+
+    ~Checkpointer() { finish(); }
+
+    // Packing grid (generation done) on the calling thread and handing it to the writer.
+    void submit(const LifeGrid& grid, uint64_t generation)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        const size_t rowBytes = packedRowBytes(grid.cols);
+
+        staging.assign(rowBytes * grid.rows, 0);
+
+        uint8_t* packed = staging.data();
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < grid.rows; i++)
+        {
+            const uint8_t* cells = grid.row(i);
+            uint8_t* out = packed + (size_t)i * rowBytes;
+
+            for (int j = 0; j < grid.cols; j++)
+                out[j >> 3] |= (uint8_t)(cells[j] << (j & 7));
+        }
+
+        handOff(grid.rows, grid.cols, generation, start);
+    }
+
+    // Same for a bit-packed grid: its words already hold 8 cells per byte, in the same bit order.
+    void submit(const BitGrid& grid, uint64_t generation)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        const size_t rowBytes = packedRowBytes(grid.cols);
+
+        staging.resize(rowBytes * grid.rows);
+
+        uint8_t* packed = staging.data();
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < grid.rows; i++)
+        {
+            const uint64_t* words = grid.row(i);
+            uint8_t* out = packed + (size_t)i * rowBytes;
+
+            for (size_t b = 0; b < rowBytes; b++)
+            {
+                uint64_t word = words[b >> 3];
+
+                if ((int)(b >> 3) == grid.wordsPerRow - 1)
+                    word &= grid.lastMask;
+
+                out[b] = (uint8_t)(word >> (8 * (b & 7)));
+            }
+        }
+
+        handOff(grid.rows, grid.cols, generation, start);
+    }
+
+    // Writing whatever is still pending and stopping the writer thread.
+    void finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            stopping = true;
+        }
+
+        ready.notify_one();
+
+        if (writer.joinable())
+            writer.join();
+    }
+
+    CheckpointStats getStats()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        return stats;
+    }
+
+private:
+    std::string path;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+
+    std::vector<uint8_t> staging, pending, writing;  // Compute side, hand-off slot, writer side
+
+    int pendingRows = 0, pendingCols = 0;
+    uint64_t pendingGeneration = 0;
+    bool hasPending = false;
+    bool stopping = false;
+
+    CheckpointStats stats;
+
+    std::thread writer;  // Declared last so every member above is constructed before it starts
+
+    // Handing the snapshot packed into staging to the writer (superseding one still waiting).
+    void handOff(int rows, int cols, uint64_t generation, std::chrono::steady_clock::time_point start)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (hasPending)
+                stats.superseded++;
+
+            pending.swap(staging);
+            pendingRows = rows;
+            pendingCols = cols;
+            pendingGeneration = generation;
+            hasPending = true;
+            stats.packSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        ready.notify_one();
+    }
+
+    void writerLoop()
+    {
+        std::vector<uint8_t> compressed;
+
+        for (;;)
+        {
+            int rows, cols;
+            uint64_t generation;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                ready.wait(lock, [&] { return hasPending || stopping; });
+
+                if (!hasPending)
+                    return;
+
+                writing.swap(pending);
+                rows = pendingRows;
+                cols = pendingCols;
+                generation = pendingGeneration;
+                hasPending = false;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+
+            compressRuns(writing, compressed);
+
+            bool ok = writeFile(rows, cols, generation, compressed);
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (ok)
+            {
+                stats.written++;
+                stats.lastGeneration = generation;
+                stats.lastRawBytes = writing.size();
+                stats.lastCompressedBytes = compressed.size();
+            }
+            else
+                stats.failed++;
+
+            stats.writeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    bool writeFile(int rows, int cols, uint64_t generation, const std::vector<uint8_t>& compressed)
+    {
+        std::string temporary = path + ".tmp";
+        FILE* f = fopen(temporary.c_str(), "wb");
+
+        if (!f)
+            return false;
+
+        uint8_t header[CHECKPOINT_HEADER_BYTES];
+        uint8_t* out = header;
+
+        out = putLittle(out, (uint32_t)rows, 4);
+        out = putLittle(out, (uint32_t)cols, 4);
+        out = putLittle(out, generation, 8);
+        out = putLittle(out, writing.size(), 8);
+        out = putLittle(out, compressed.size(), 8);
+        putLittle(out, crc32(writing.data(), writing.size()), 4);
+
+        bool ok = fwrite("LIFECKP1", 1, 8, f) == 8 && fwrite(header, 1, sizeof(header), f) == sizeof(header)
+               && fwrite(compressed.data(), 1, compressed.size(), f) == compressed.size();
+
+        ok = fclose(f) == 0 && ok;
+
+        return ok && rename(temporary.c_str(), path.c_str()) == 0;
+    }
+};
+
+// Reading a checkpoint into grid (reallocated to its size). On failure, error holds a message and false is returned.
+inline bool loadCheckpoint(const std::string& path, LifeGrid& grid, uint64_t& generation, std::string& error)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+
+    if (!f)
+    {
+        error = "cannot open " + path;
+
+        return false;
+    }
+
+    // The file size bounds every length the header may claim
+    long fileBytes = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+
+    char magic[8];
+    uint8_t header[CHECKPOINT_HEADER_BYTES];
+    uint64_t dims[2] = {0, 0}, sizes[3] = {0, 0, 0}, crc = 0;
+
+    bool ok = fileBytes >= (long)(8 + CHECKPOINT_HEADER_BYTES) && fseek(f, 0, SEEK_SET) == 0 && fread(magic, 1, 8, f) == 8 && memcmp(magic, "LIFECKP1", 8) == 0 && fread(header, 1, sizeof(header), f) == sizeof(header);
+
+    if (ok)
+    {
+        const uint8_t* in = header;
+
+        in = getLittle(in, dims[0], 4);
+        in = getLittle(in, dims[1], 4);
+        in = getLittle(in, sizes[0], 8);
+        in = getLittle(in, sizes[1], 8);
+        in = getLittle(in, sizes[2], 8);
+        getLittle(in, crc, 4);
+
+        // A compressed byte expands to at most 65 packed bytes (a 2-byte run of 130)
+        ok = dims[0] > 0 && dims[1] > 0 && dims[0] <= INT32_MAX && dims[1] <= INT32_MAX
+          && sizes[1] == (dims[1] + 7) / 8 * dims[0]
+          && sizes[2] <= (uint64_t)fileBytes - 8 - CHECKPOINT_HEADER_BYTES && sizes[1] <= sizes[2] * 65;
+    }
+
+    std::vector<uint8_t> compressed, packed;
+
+    if (ok)
+    {
+        compressed.resize(sizes[2]);
+        ok = fread(compressed.data(), 1, compressed.size(), f) == compressed.size();
+    }
+
+    fclose(f);
+
+    if (!ok)
+    {
+        error = path + " is not a Life checkpoint or is truncated";
+
+        return false;
+    }
+
+    if (!expandRuns(compressed.data(), compressed.size(), packed, sizes[1]) || crc32(packed.data(), packed.size()) != crc)
+    {
+        error = path + " is corrupted (checksum mismatch)";
+
+        return false;
+    }
+
+    LifeGrid loaded((int)dims[0], (int)dims[1]);
+    const size_t rowBytes = packedRowBytes(loaded.cols);
+
+    for (int i = 0; i < loaded.rows; i++)
+    {
+        for (int j = 0; j < loaded.cols; j++)
+            loaded.row(i)[j] = (packed[(size_t)i * rowBytes + (j >> 3)] >> (j & 7)) & 1;
+    }
+
+    grid.swap(loaded);
+    generation = sizes[0];
+
+    return true;
+}
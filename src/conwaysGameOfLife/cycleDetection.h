@@ -0,0 +1,243 @@
+/********************************************************************
+ * File:        cycleDetection.h
+ *
+ * Description: Early termination for Life runs that settle into a still
+ *              life or an oscillator. Every row is hashed right after the
+ *              update writes it (while it is still in cache), mixed with
+ *              its row index, and the row hashes are summed with an OpenMP
+ *              reduction into a generation hash. A bounded ring of recent
+ *              generation hashes is searched for a repeat; a match at
+ *              distance p is only a candidate, and is verified by advancing
+ *              a copy of the grid p generations and comparing it cell by
+ *              cell. Once a period is confirmed the remaining generations
+ *              reduce to (remaining mod p), so the final grid is identical
+ *              to the one a full run would produce.
+ *
+ *              Engines that do not finish a whole generation at a time
+ *              (temporal blocks, dataflow bands) hash the grid at their own
+ *              synchronization points instead. A repeat between those is a
+ *              multiple of the period, which verification reduces to the
+ *              smallest period that holds. The bit-packed engine hashes its
+ *              packed words, so its hashes are only compared with each other.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <omp.h>
+
+#include "bitLife.h"
+#include "lifeGrid.h"
+
+// Final mix (MurmurHash3 fmix64) of a row hash with the row index.
+inline uint64_t mixRowHash(uint64_t h, int i)
+{
+    h ^= (uint64_t)i * 0xC2B2AE3D27D4EB4FULL;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+
+    return h;
+}
+
+// Hash of one grid row, keyed by its index so equal rows at different heights differ.
+inline uint64_t hashLifeRow(const uint8_t* row, int cols, int i)
+{
+    uint64_t h = 0x84222325CBF29CE4ULL ^ (uint64_t)cols;
+    int j = 0;
+
+    for (; j + 8 <= cols; j += 8)
+    {
+        uint64_t word;
+
+        memcpy(&word, row + j, 8);
+
+        h = (h ^ word) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 32;
+    }
+
+    for (; j < cols; j++)
+        h = (h ^ row[j]) * 0x100000001B3ULL;
+
+    return mixRowHash(h, i);
+}
+
+// Generation hash of a whole grid: the sum of its row hashes (as accumulated by the update loops).
+inline uint64_t hashLifeGrid(const LifeGrid& grid)
+{
+    uint64_t hash = 0;
+
+    #pragma omp parallel for schedule(static) reduction(+:hash)
+    for (int i = 0; i < grid.rows; i++)
+        hash += hashLifeRow(grid.row(i), grid.cols, i);
+
+    return hash;
+}
+
+// Generation hash of a bit-packed grid, one word (64 cells) at a time.
+inline uint64_t hashBitGrid(const BitGrid& grid)
+{
+    uint64_t hash = 0;
+
+    #pragma omp parallel for schedule(static) reduction(+:hash)
+    for (int i = 0; i < grid.rows; i++)
+    {
+        const uint64_t* words = grid.row(i);
+        uint64_t h = 0x84222325CBF29CE4ULL ^ (uint64_t)grid.cols;
+
+        for (int w = 0; w < grid.wordsPerRow; w++)
+        {
+            h = (h ^ words[w]) * 0x9E3779B97F4A7C15ULL;
+            h ^= h >> 32;
+        }
+
+        hash += mixRowHash(h, i);
+    }
+
+    return hash;
+}
+
+// Advancing grid by the given number of generations with the plain row update.
+inline void advanceLifeGrid(LifeGrid& grid, int generations)
+{
+    if (generations <= 0)
+        return;
+
+    LifeGrid next(grid.rows, grid.cols);
+
+    for (int gen = 0; gen < generations; gen++)
+    {
+        grid.refreshGhosts();
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < grid.rows; i++)
+            updateLifeRow(grid, next, i);
+
+        grid.swap(next);
+    }
+}
+
+// True if grid comes back to itself after period generations.
+inline bool hasPeriod(const LifeGrid& grid, int period)
+{
+    LifeGrid copy(grid.rows, grid.cols);
+
+    for (int i = 0; i < grid.rows; i++)
+        memcpy(copy.row(i), grid.row(i), grid.cols);
+
+    advanceLifeGrid(copy, period);
+
+    for (int i = 0; i < grid.rows; i++)
+    {
+        if (memcmp(copy.row(i), grid.row(i), grid.cols) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+struct CycleReport
+{
+    bool found = false;
+    int period = 0;            // 1 is a fixed point (still life or empty grid)
+    int detectedAt = 0;        // Generation (within the run) at which the repeat was confirmed
+    int repeatOf = 0;          // Earlier generation whose grid it repeated
+    int skipped = 0;           // Generations not computed thanks to the early stop
+    int falseMatches = 0;      // Hash repeats that did not survive verification
+};
+
+class CycleDetector
+{
+public:
+    explicit CycleDetector(int historySize) : history(historySize > 0 ? historySize : 1) {}
+
+    // Recording the hash of the grid after generation gen (generations must increase); returns the
+    // distance to the latest earlier generation with the same hash (a candidate period to verify), or 0.
+    int record(uint64_t hash, int gen)
+    {
+        const int size = (int)history.size();
+        int candidate = 0;
+
+        for (int back = 1; back <= recorded && back <= size && candidate == 0; back++)
+        {
+            const Entry& e = history[(recorded - back) % size];
+
+            if (e.hash == hash)
+                candidate = gen - e.gen;
+        }
+
+        if (recorded > 0)
+            stride = std::max(stride, gen - history[(recorded - 1) % size].gen);
+
+        history[recorded % size] = Entry{hash, gen};
+        recorded++;
+
+        return candidate;
+    }
+
+    // Verifying a candidate period returned by record for generation gen of a run of totalGenerations.
+    // Returns true if grid is in a cycle; grid has then been advanced to the state of generation totalGenerations.
+    bool confirm(LifeGrid& grid, int candidate, int gen, int totalGenerations)
+    {
+        if (!hasPeriod(grid, candidate))
+        {
+            report.falseMatches++;
+
+            return false;
+        }
+
+        // With generations skipped between hashes the repeat can be a multiple of the period
+        int period = candidate;
+
+        for (int d = 1; d < candidate && stride > 1; d++)
+        {
+            if (candidate % d == 0 && hasPeriod(grid, d))
+            {
+                period = d;
+
+                break;
+            }
+        }
+
+        int remaining = totalGenerations - gen;
+
+        advanceLifeGrid(grid, remaining % period);
+
+        report.found = true;
+        report.period = period;
+        report.detectedAt = gen;
+        report.repeatOf = gen - candidate;
+        report.skipped = remaining - remaining % period;
+
+        return true;
+    }
+
+    // Handling the hash of generation gen of a run of totalGenerations (record, then confirm a candidate).
+    bool stopOnCycle(LifeGrid& grid, uint64_t hash, int gen, int totalGenerations)
+    {
+        int candidate = record(hash, gen);
+
+        return candidate != 0 && confirm(grid, candidate, gen, totalGenerations);
+    }
+
+    const CycleReport& getReport() const { return report; }
+
+private:
+    struct Entry
+    {
+        uint64_t hash;
+        int gen;
+    };
+
+    std::vector<Entry> history;  // Ring of the last history.size() generation hashes
+
+    int recorded = 0;
+    int stride = 1;              // Largest gap between recorded generations
+
+    CycleReport report;
+};
@@ -0,0 +1,157 @@
+/********************************************************************
+ * File:        dataflowLife.h
+ *
+ * Description: Barrier-free Game of Life stepping with OpenMP task
+ *              dependencies. One parallel region lives for the whole run;
+ *              the grid is split into row bands and generation g of band b
+ *              is a task that depends only on generation g-1 of bands b-1,
+ *              b and b+1 (toroidally), so fast bands run ahead of slow ones
+ *              instead of waiting at a per-generation barrier.
+ *
+ *              Generation g is written to buffer g % 2. The dependence
+ *              objects are indexed by (parity, band), so the out dependence
+ *              of (g, b) also waits for the three generation g-1 readers of
+ *              the generation g-2 band it overwrites. Each task refreshes
+ *              the ghost cells of its own rows, since there is no global
+ *              step at which to do it.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <omp.h>
+
+#include "lifeGrid.h"
+
+struct DataflowLifeStats
+{
+    int bands = 0;
+    int maxSkew = 0;          // Largest observed gap in completed generations between bands
+    double averageSkew = 0;   // Mean gap observed at task completion
+    double wallTime = 0;
+
+    std::vector<double> busyTime;  // Per thread: seconds spent inside band tasks
+    std::vector<long> tasks;       // Per thread: band tasks executed
+};
+
+// Advancing grid by the given number of generations with one task per (generation, band). With a hook, the
+// task graph is cut every syncEvery generations: each part runs in its own parallel region and the hook runs
+// between them, so band skew is bounded by syncEvery.
+inline void dataflowLifeRun(LifeGrid& grid, int generations, int bandRows, DataflowLifeStats& stats,
+                            const LifeSyncHook& afterPart = nullptr, int syncEvery = 16)
+{
+    const int rows = grid.rows, cols = grid.cols;
+    const int bands = (rows + bandRows - 1) / bandRows;
+    const int threads = omp_get_max_threads();
+
+    LifeGrid other(rows, cols);
+    LifeGrid* buffers[2] = {&grid, &other};
+
+    grid.refreshGhosts();
+
+    // Dependence objects (only their addresses matter) and the last completed generation per band
+    std::vector<char> depStorage(2 * bands);
+    char* deps = depStorage.data();
+    std::unique_ptr<std::atomic<int>[]> progress(new std::atomic<int>[bands]);
+
+    for (int b = 0; b < bands; b++)
+        progress[b].store(0, std::memory_order_relaxed);
+
+    std::vector<double> busy(threads, 0.0);
+    std::vector<long> taskCount(threads, 0);
+    std::vector<long> skewSum(threads, 0);
+    std::vector<int> skewMax(threads, 0);
+
+    const int segment = afterPart ? std::max(syncEvery, 1) : std::max(generations, 1);
+
+    stats.wallTime = 0;
+
+    for (int begin = 0; begin < generations; begin += segment)
+    {
+        const int end = std::min(generations, begin + segment);
+
+        double start = omp_get_wtime();
+
+        #pragma omp parallel
+        #pragma omp single
+        {
+            for (int g = begin + 1; g <= end; g++)
+            {
+                const int prev = ((g - 1) % 2) * bands, cur = (g % 2) * bands;
+
+                for (int b = 0; b < bands; b++)
+                {
+                    const int up = (b + bands - 1) % bands, down = (b + 1) % bands;
+
+                    #pragma omp task firstprivate(g, b) depend(in: *(deps + prev + up), *(deps + prev + b), *(deps + prev + down)) depend(out: *(deps + cur + b))
+                    {
+                        double taskStart = omp_get_wtime();
+                        int tid = omp_get_thread_num();
+
+                        const LifeGrid& current = *buffers[(g - begin - 1) % 2];
+                        LifeGrid& next = *buffers[(g - begin) % 2];
+
+                        int rowBegin = b * bandRows, rowEnd = std::min(rows, rowBegin + bandRows);
+
+                        for (int i = rowBegin; i < rowEnd; i++)
+                        {
+                            updateLifeRow(current, next, i);
+
+                            uint8_t* r = next.row(i);
+
+                            r[-1] = r[cols - 1];
+                            r[cols] = r[0];
+                        }
+
+                        // The ghost rows belong to the bands holding the rows they copy
+                        if (rowBegin == 0)
+                            memcpy(next.row(rows) - 1, next.row(0) - 1, next.pitch);
+                        if (rowEnd == rows)
+                            memcpy(next.row(-1) - 1, next.row(rows - 1) - 1, next.pitch);
+
+                        progress[b].store(g, std::memory_order_release);
+
+                        int slowest = g;
+
+                        for (int k = 0; k < bands; k++)
+                            slowest = std::min(slowest, progress[k].load(std::memory_order_relaxed));
+
+                        skewSum[tid] += g - slowest;
+                        skewMax[tid] = std::max(skewMax[tid], g - slowest);
+                        taskCount[tid]++;
+                        busy[tid] += omp_get_wtime() - taskStart;
+                    }
+                }
+            }
+        }
+
+        stats.wallTime += omp_get_wtime() - start;
+
+        // Generation g is in buffers[(g - begin) % 2]
+        if ((end - begin) % 2)
+            grid.swap(other);
+
+        if (afterPart && afterPart(grid, end, end - begin))
+            break;
+    }
+
+    long totalTasks = 0, totalSkew = 0;
+
+    stats.bands = bands;
+    stats.maxSkew = 0;
+
+    for (int t = 0; t < threads; t++)
+    {
+        totalTasks += taskCount[t];
+        totalSkew += skewSum[t];
+        stats.maxSkew = std::max(stats.maxSkew, skewMax[t]);
+    }
+
+    stats.averageSkew = totalTasks ? (double)totalSkew / totalTasks : 0.0;
+    stats.busyTime = busy;
+    stats.tasks = taskCount;
+}
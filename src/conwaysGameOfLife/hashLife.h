@@ -0,0 +1,537 @@
+/********************************************************************
+ * File:        hashLife.h
+ *
+ * Description: HashLife engine for very long runs. Patterns are stored as
+ *              hash-consed quadtrees: every distinct node exists once in a
+ *              canonical table, and the future of a node (its center after
+ *              2^j generations) is memoized. Steps are powers of two.
+ *
+ *              The simulation runs on the same torus as the other
+ *              versions, treated as an infinite periodic plane. On a
+ *              2^k x 2^k torus the periodic tiling is itself a small node
+ *              (all four quadrants equal), so a jump never leaves the
+ *              quadtree and runs of 10^6+ generations are cheap for
+ *              structured patterns. Other sizes build a periodic window
+ *              around the torus for every jump, which is correct but costs
+ *              O(window area) per jump.
+ *
+ *              The footprint is checked at every memo lookup, inside jumps
+ *              as well as between them. Past three quarters of the memory
+ *              cap the memo is dropped (it is only a cache), then
+ *              unreachable nodes are garbage-collected; the ids still in
+ *              use by unfinished result() calls are kept on a pinned
+ *              stack, which the collector treats as roots and remaps.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "lifeGrid.h"
+
+struct HashLifeStats
+{
+    uint64_t memoHits = 0;
+    uint64_t memoMisses = 0;
+    uint64_t nodesCreated = 0;
+    uint64_t garbageCollections = 0;
+    uint64_t jumps = 0;
+
+    size_t liveNodes = 0;
+    size_t bytesUsed = 0;
+    size_t peakBytes = 0;
+
+    bool capExceeded = false;  // The peak went over the cap (the live set alone did not fit)
+};
+
+class HashLife
+{
+public:
+    typedef uint32_t NodeId;
+
+    explicit HashLife(size_t memoryCapBytes) : memoryCap(memoryCapBytes), collectAt(memoryCapBytes / 4 * 3)
+    {
+        reset();
+    }
+
+    // Advancing the rows x cols torus stored in grid by the given number of generations.
+    void run(LifeGrid& grid, uint64_t generations)
+    {
+        const int rows = grid.rows, cols = grid.cols;
+
+        int k = 0;
+
+        while ((1 << k) < std::max(rows, cols))
+            k++;
+
+        if (rows == cols && rows == (1 << k) && k >= 1)
+            runPowerOfTwo(grid, k, generations);
+        else
+            runWindowed(grid, generations);
+    }
+
+    const HashLifeStats& getStats() const { return stats; }
+
+private:
+    struct Node
+    {
+        NodeId nw, ne, sw, se;
+
+        uint32_t level;
+    };
+
+    struct NodeKey
+    {
+        NodeId nw, ne, sw, se;
+
+        bool operator==(const NodeKey& o) const
+        {
+            return nw == o.nw && ne == o.ne && sw == o.sw && se == o.se;
+        }
+    };
+
+    struct NodeKeyHash
+    {
+        size_t operator()(const NodeKey& key) const
+        {
+            uint64_t h = (uint64_t)key.nw * 0x9E3779B97F4A7C15ULL;
+
+            h ^= (uint64_t)key.ne + 0x632BE59BD9B4E019ULL + (h << 6) + (h >> 2);
+            h ^= (uint64_t)key.sw * 0xC2B2AE3D27D4EB4FULL + (h << 6) + (h >> 2);
+            h ^= (uint64_t)key.se + 0x165667B19E3779F9ULL + (h << 6) + (h >> 2);
+
+            return (size_t)(h ^ (h >> 29));
+        }
+    };
+
+    // Ids 0 and 1 are the dead and live level-0 leaves
+    std::vector<Node> nodes;
+    std::unordered_map<NodeKey, NodeId, NodeKeyHash> table;
+    std::unordered_map<uint64_t, NodeId> memo;  // (node << 6 | j) -> center after 2^j generations
+    std::vector<NodeId> emptyByLevel;
+
+    size_t memoryCap;
+    size_t collectAt;  // Footprint that triggers dropping the memo and collecting
+
+    // Node ids held by unfinished result() calls and the run loops; roots for the collector, remapped by it
+    std::vector<NodeId> pinned;
+
+    HashLifeStats stats;
+
+    void reset()
+    {
+        nodes.assign(2, Node{0, 0, 0, 0, 0});
+        table.clear();
+        memo.clear();
+        emptyByLevel.assign(1, 0);
+    }
+
+    // Approximate footprint: node array plus hash-table entries (key, value, bucket and list overhead)
+    size_t bytesUsed() const
+    {
+        return nodes.capacity() * sizeof(Node) + table.size() * (sizeof(NodeKey) + sizeof(NodeId) + 32)
+             + table.bucket_count() * sizeof(void*) + memo.size() * (sizeof(uint64_t) + sizeof(NodeId) + 32)
+             + memo.bucket_count() * sizeof(void*);
+    }
+
+    // Canonical node lookup (hash-consing)
+    NodeId join(NodeId nw, NodeId ne, NodeId sw, NodeId se)
+    {
+        NodeKey key{nw, ne, sw, se};
+        auto it = table.find(key);
+
+        if (it != table.end())
+            return it->second;
+
+        NodeId id = (NodeId)nodes.size();
+
+        // Growing the node array by half rather than doubling it, so one growth step cannot jump past the cap
+        if (nodes.size() == nodes.capacity())
+            nodes.reserve(nodes.capacity() + nodes.capacity() / 2 + 16);
+
+        nodes.push_back(Node{nw, ne, sw, se, nodes[nw].level + 1});
+        table.emplace(key, id);
+        stats.nodesCreated++;
+
+        return id;
+    }
+
+    NodeId emptyNode(uint32_t level)
+    {
+        while (emptyByLevel.size() <= level)
+        {
+            NodeId e = emptyByLevel.back();
+
+            emptyByLevel.push_back(join(e, e, e, e));
+        }
+
+        return emptyByLevel[level];
+    }
+
+    // Level L-1 node at the center of a level L node, with no time passing
+    NodeId center(NodeId id)
+    {
+        const Node n = nodes[id];
+
+        return join(nodes[n.nw].se, nodes[n.ne].sw, nodes[n.sw].ne, nodes[n.se].nw);
+    }
+
+    // One generation of the center 2x2 of a 4x4 (level 2) node
+    NodeId baseStep(NodeId id)
+    {
+        const Node n = nodes[id];
+        int cell[4][4];
+
+        const NodeId quads[4] = {n.nw, n.ne, n.sw, n.se};
+
+        for (int q = 0; q < 4; q++)
+        {
+            const Node& sub = nodes[quads[q]];
+            int y = (q / 2) * 2, x = (q % 2) * 2;
+
+            cell[y][x] = sub.nw;
+            cell[y][x + 1] = sub.ne;
+            cell[y + 1][x] = sub.sw;
+            cell[y + 1][x + 1] = sub.se;
+        }
+
+        NodeId out[4];
+
+        for (int q = 0; q < 4; q++)
+        {
+            int y = 1 + q / 2, x = 1 + q % 2;
+            int liveNeighbors = 0;
+
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    if (dy || dx)
+                        liveNeighbors += cell[y + dy][x + dx];
+                }
+            }
+
+            out[q] = (liveNeighbors == 3 || (cell[y][x] && liveNeighbors == 2)) ? 1 : 0;
+        }
+
+        return join(out[0], out[1], out[2], out[3]);
+    }
+
+    // Center (level L-1) of a level L node after 2^j generations, 0 <= j <= L-2. The start of each call is
+    // a safe point for the cap; every id needed after a nested call lives in this call's pinned frame:
+    // [0] the node, [1..9] the sub-squares and then their results, [10..13] the output quadrants.
+    NodeId result(NodeId id, uint32_t j)
+    {
+        const size_t frame = pinned.size();
+
+        pinned.push_back(id);
+        enforceCap();
+        id = pinned[frame];
+
+        const uint32_t level = nodes[id].level;
+
+        if (level == 2 || id == emptyNode(level))
+        {
+            pinned.resize(frame);
+
+            // An empty region stays empty
+            return level == 2 ? baseStep(id) : emptyNode(level - 1);
+        }
+
+        auto it = memo.find(((uint64_t)id << 6) | j);
+
+        if (it != memo.end())
+        {
+            stats.memoHits++;
+            pinned.resize(frame);
+
+            return it->second;
+        }
+
+        stats.memoMisses++;
+
+        const Node n = nodes[id];
+        const Node nw = nodes[n.nw], ne = nodes[n.ne], sw = nodes[n.sw], se = nodes[n.se];
+
+        // Nine overlapping level L-1 sub-squares
+        const NodeId sub[9] = {
+            n.nw,
+            join(nw.ne, ne.nw, nw.se, ne.sw),
+            n.ne,
+            join(nw.sw, nw.se, sw.nw, sw.ne),
+            join(nw.se, ne.sw, sw.ne, se.nw),
+            join(ne.sw, ne.se, se.nw, se.ne),
+            n.sw,
+            join(sw.ne, se.nw, sw.se, se.sw),
+            n.se
+        };
+
+        pinned.insert(pinned.end(), sub, sub + 9);
+        pinned.resize(frame + 14);
+
+        // Full-speed steps spend half the time in each stage; slower steps only take centers first
+        const bool fullSpeed = j == level - 2;
+
+        for (int s = 0; s < 9; s++)
+        {
+            NodeId r = fullSpeed ? result(pinned[frame + 1 + s], level - 3) : center(pinned[frame + 1 + s]);
+
+            pinned[frame + 1 + s] = r;
+        }
+
+        const uint32_t second = fullSpeed ? level - 3 : j;
+        const int quadrants[4][4] = {{0, 1, 3, 4}, {1, 2, 4, 5}, {3, 4, 6, 7}, {4, 5, 7, 8}};
+
+        for (int q = 0; q < 4; q++)
+        {
+            const NodeId* r = &pinned[frame + 1];
+            NodeId out = result(join(r[quadrants[q][0]], r[quadrants[q][1]], r[quadrants[q][2]], r[quadrants[q][3]]), second);
+
+            pinned[frame + 10 + q] = out;
+        }
+
+        const NodeId* o = &pinned[frame + 10];
+        NodeId out = join(o[0], o[1], o[2], o[3]);
+
+        memo.emplace(((uint64_t)pinned[frame] << 6) | j, out);
+        pinned.resize(frame);
+
+        return out;
+    }
+
+    // Building a level L node whose cell (y, x) is given by cellAt
+    NodeId build(uint32_t level, int64_t y, int64_t x, const std::function<int(int64_t, int64_t)>& cellAt)
+    {
+        if (level == 0)
+            return cellAt(y, x) ? 1 : 0;
+
+        int64_t half = (int64_t)1 << (level - 1);
+
+        return join(build(level - 1, y, x, cellAt), build(level - 1, y, x + half, cellAt),
+                    build(level - 1, y + half, x, cellAt), build(level - 1, y + half, x + half, cellAt));
+    }
+
+    // Writing rows [0, rows) x [0, cols) of a level L node (origin at y0, x0) into grid
+    void extract(NodeId id, int64_t y0, int64_t x0, LifeGrid& grid)
+    {
+        const uint32_t level = nodes[id].level;
+        const int64_t size = (int64_t)1 << level;
+
+        if (y0 >= grid.rows || x0 >= grid.cols || y0 + size <= 0 || x0 + size <= 0)
+            return;
+
+        if (level == 0)
+        {
+            grid.row((int)y0)[x0] = (uint8_t)id;
+
+            return;
+        }
+
+        const Node n = nodes[id];
+        const int64_t half = size / 2;
+
+        extract(n.nw, y0, x0, grid);
+        extract(n.ne, y0, x0 + half, grid);
+        extract(n.sw, y0 + half, x0, grid);
+        extract(n.se, y0 + half, x0 + half, grid);
+    }
+
+    // Collecting nodes reachable from the pinned ids, compacting the table and dropping the memo.
+    void collectGarbage()
+    {
+        std::vector<uint8_t> marked(nodes.size(), 0);
+        std::vector<NodeId> stack(pinned.begin(), pinned.end());
+
+        marked[0] = marked[1] = 1;
+
+        for (NodeId e : emptyByLevel)
+            stack.push_back(e);
+
+        while (!stack.empty())
+        {
+            NodeId id = stack.back();
+
+            stack.pop_back();
+
+            if (marked[id])
+                continue;
+
+            marked[id] = 1;
+
+            const Node& n = nodes[id];
+
+            stack.push_back(n.nw);
+            stack.push_back(n.ne);
+            stack.push_back(n.sw);
+            stack.push_back(n.se);
+        }
+
+        // Children always have smaller ids than their parents, so one forward pass remaps everything
+        std::vector<NodeId> remap(nodes.size(), 0);
+        std::vector<Node> kept;
+
+        kept.reserve(nodes.size());
+
+        for (NodeId id = 0; id < nodes.size(); id++)
+        {
+            if (!marked[id])
+                continue;
+
+            Node n = nodes[id];
+
+            if (id > 1)
+            {
+                n.nw = remap[n.nw];
+                n.ne = remap[n.ne];
+                n.sw = remap[n.sw];
+                n.se = remap[n.se];
+            }
+
+            remap[id] = (NodeId)kept.size();
+            kept.push_back(n);
+        }
+
+        nodes.swap(kept);
+        nodes.shrink_to_fit();
+        memo.clear();
+        memo.rehash(0);
+        table.clear();
+        table.rehash(0);
+
+        for (NodeId id = 2; id < nodes.size(); id++)
+        {
+            const Node& n = nodes[id];
+
+            table.emplace(NodeKey{n.nw, n.ne, n.sw, n.se}, id);
+        }
+
+        for (NodeId& e : emptyByLevel)
+            e = remap[e];
+        for (NodeId& root : pinned)
+            root = remap[root];
+
+        stats.garbageCollections++;
+    }
+
+    // Keeping the footprint under the cap at a safe point (every id still in use is pinned): dropping the
+    // memo first, then collecting garbage. Returns false if the live set alone is past the trigger.
+    bool enforceCap()
+    {
+        size_t bytes = bytesUsed();
+
+        stats.peakBytes = std::max(stats.peakBytes, bytes);
+        stats.capExceeded = stats.peakBytes > memoryCap;
+
+        if (bytes <= collectAt)
+            return true;
+
+        memo.clear();
+        memo.rehash(0);
+
+        if (bytesUsed() > collectAt)
+            collectGarbage();
+
+        bytes = bytesUsed();
+
+        // A live set past the trigger would be collected again at every safe point; waiting until it doubles
+        bool fits = bytes <= memoryCap / 4 * 3;
+
+        collectAt = fits ? memoryCap / 4 * 3 : 2 * bytes;
+
+        return fits;
+    }
+
+    void finishStats()
+    {
+        stats.liveNodes = nodes.size();
+        stats.bytesUsed = bytesUsed();
+        stats.peakBytes = std::max(stats.peakBytes, stats.bytesUsed);
+        stats.capExceeded = stats.peakBytes > memoryCap;
+    }
+
+    // 2^k x 2^k torus: the periodic plane tiled 2^m x 2^m times is a chain of m self-joined nodes.
+    // With m >= 2 the result of that tiling is again a tiling of the new torus, aligned at the origin.
+    void runPowerOfTwo(LifeGrid& grid, uint32_t k, uint64_t generations)
+    {
+        NodeId torus = build(k, 0, 0, [&](int64_t y, int64_t x) { return (int)grid.row((int)y)[x]; });
+
+        // Largest step allowed while the memory cap holds; shrinks if jumps keep overflowing it
+        uint32_t maxStep = 62;
+
+        while (generations > 0)
+        {
+            uint32_t j = 0;
+
+            while (j + 1 <= maxStep && (generations >> (j + 1)) != 0 && j + 1 < 62)
+                j++;
+
+            uint32_t m = std::max<uint32_t>(2, j + 2 > k ? j + 2 - k : 0);
+            NodeId tiled = torus;
+
+            for (uint32_t t = 0; t < m; t++)
+                tiled = join(tiled, tiled, tiled, tiled);
+
+            NodeId next = result(tiled, j);
+
+            for (uint32_t t = 0; t + 1 < m; t++)
+                next = nodes[next].nw;
+
+            torus = next;
+            generations -= (uint64_t)1 << j;
+            stats.jumps++;
+
+            pinned.push_back(torus);
+
+            if (!enforceCap() && maxStep > 0)
+                maxStep = j > 0 ? j - 1 : 0;
+
+            torus = pinned.back();
+            pinned.pop_back();
+        }
+
+        extract(torus, 0, 0, grid);
+        finishStats();
+    }
+
+    // Any torus: a window of the periodic plane with a margin of 2^(L-2) cells is rebuilt for every
+    // jump, and the center is folded back onto the torus.
+    void runWindowed(LifeGrid& grid, uint64_t generations)
+    {
+        const int rows = grid.rows, cols = grid.cols;
+
+        uint32_t level = 2;
+
+        while (((int64_t)1 << (level - 1)) < std::max(rows, cols))
+            level++;
+
+        const int64_t margin = (int64_t)1 << (level - 2);
+
+        while (generations > 0)
+        {
+            uint32_t j = 0;
+
+            while (j + 1 <= level - 2 && (generations >> (j + 1)) != 0)
+                j++;
+
+            NodeId window = build(level, 0, 0, [&](int64_t y, int64_t x) {
+                int64_t ty = ((y - margin) % rows + rows) % rows;
+                int64_t tx = ((x - margin) % cols + cols) % cols;
+
+                return (int)grid.row((int)ty)[tx];
+            });
+
+            extract(result(window, j), 0, 0, grid);
+
+            generations -= (uint64_t)1 << j;
+            stats.jumps++;
+
+            enforceCap();
+        }
+
+        finishStats();
+    }
+};
@@ -0,0 +1,132 @@
+/********************************************************************
+ * File:        lifeGrid.h
+ *
+ * Description: Runtime-sized Game of Life grid stored as one contiguous
+ *              buffer of 0/1 bytes with a one-cell ghost border. The ghost
+ *              cells are refreshed from the opposite edges once per
+ *              generation, so the neighbor count in the hot loop is a plain
+ *              sum of eight bytes with no modulo and no branches.
+ ********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+struct LifeGrid
+{
+    int rows = 0;
+    int cols = 0;
+    int pitch = 0;  // cols + 2 ghost columns
+
+    std::unique_ptr<uint8_t[]> cells;  // (rows + 2) x pitch; left uninitialized by new[] for first touch
+
+    LifeGrid() = default;
+
+    // touchChunk > 0 zeroes rows with schedule(static, touchChunk), otherwise schedule(static),
+    // so pages are first touched by the threads of the matching compute loop.
+    LifeGrid(int r, int c, int touchChunk = 0)
+    {
+        rows = r;
+        cols = c;
+        pitch = c + 2;
+        cells.reset(new uint8_t[(size_t)(rows + 2) * pitch]);
+
+        if (touchChunk > 0)
+        {
+            #pragma omp parallel for schedule(static, touchChunk)
+            for (int i = 0; i < rows + 2; i++)
+                memset(cells.get() + (size_t)i * pitch, 0, pitch);
+        }
+        else
+        {
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < rows + 2; i++)
+                memset(cells.get() + (size_t)i * pitch, 0, pitch);
+        }
+    }
+
+    // Pointer to column 0 of interior row i (i = -1 and i = rows address the ghost rows)
+    uint8_t* row(int i) { return cells.get() + (size_t)(i + 1) * pitch + 1; }
+    const uint8_t* row(int i) const { return cells.get() + (size_t)(i + 1) * pitch + 1; }
+
+    void swap(LifeGrid& other)
+    {
+        std::swap(rows, other.rows);
+        std::swap(cols, other.cols);
+        std::swap(pitch, other.pitch);
+        std::swap(cells, other.cells);
+    }
+
+    // Copying the opposite edges into the ghost border (toroidal wrap). Columns first, then
+    // whole rows including their ghost columns, which fills the corners.
+    void refreshGhosts()
+    {
+        for (int i = 0; i < rows; i++)
+        {
+            uint8_t* r = row(i);
+
+            r[-1] = r[cols - 1];
+            r[cols] = r[0];
+        }
+
+        memcpy(row(-1) - 1, row(rows - 1) - 1, pitch);
+        memcpy(row(rows) - 1, row(0) - 1, pitch);
+    }
+};
+
+// Callback the engines run at their synchronization points: grid holds the state after gen generations of the
+// run, steps of them computed since the previous call (1, or a whole block for engines that synchronize per
+// block). Returning true ends the run with grid as its result.
+typedef std::function<bool(LifeGrid& grid, int gen, int steps)> LifeSyncHook;
+
+// Computing interior row i of next from current (whose ghosts must be fresh).
+inline void updateLifeRow(const LifeGrid& current, LifeGrid& next, int i)
+{
+    const uint8_t* up = current.row(i - 1);
+    const uint8_t* mid = current.row(i);
+    const uint8_t* down = current.row(i + 1);
+
+    uint8_t* out = next.row(i);
+
+    for (int j = 0; j < current.cols; j++)
+    {
+        int liveNeighbors = up[j - 1] + up[j] + up[j + 1]
+                          + mid[j - 1]        + mid[j + 1]
+                          + down[j - 1] + down[j] + down[j + 1];
+
+        // Reproduction with exactly 3, survival with 2 or 3
+        out[j] = (uint8_t)((liveNeighbors == 3) | (mid[j] & (liveNeighbors == 2)));
+    }
+}
+
+// Conversions to and from the '*' / '.' char grid used for printing and verification
+inline std::vector<std::vector<char>> toCharGrid(const LifeGrid& grid)
+{
+    std::vector<std::vector<char>> out(grid.rows, std::vector<char>(grid.cols, '.'));
+
+    for (int i = 0; i < grid.rows; i++)
+    {
+        for (int j = 0; j < grid.cols; j++)
+        {
+            if (grid.row(i)[j])
+                out[i][j] = '*';
+        }
+    }
+
+    return out;
+}
+
+inline void fromCharGrid(const std::vector<std::vector<char>>& in, LifeGrid& grid)
+{
+    for (int i = 0; i < grid.rows; i++)
+    {
+        for (int j = 0; j < grid.cols; j++)
+            grid.row(i)[j] = in[i][j] == '*';
+    }
+}
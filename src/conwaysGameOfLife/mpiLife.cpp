@@ -0,0 +1,495 @@
+/********************************************************************
+ * File:        mpiLife.cpp
+ *
+ * Description: MPI + OpenMP hybrid Game of Life for grids larger than one
+ *              shared-memory node. The toroidal grid is split over a
+ *              periodic 2D Cartesian communicator; every rank keeps its
+ *              block in a LifeGrid whose ghost border holds the halo.
+ *              Edges and corners are exchanged with non-blocking
+ *              point-to-point calls while the block interior (which needs
+ *              no halo) is updated with OpenMP; the boundary rows and
+ *              columns are updated once the halo has arrived.
+ *
+ *              The initial pattern is the same center 10x10 block as in
+ *              main.cpp, so the gathered grid is compared with a serial
+ *              run of the same rule (--verify). --scaling runs strong- and
+ *              weak-scaling sweeps on 1, 2, 4, ... of the launched ranks.
+ *
+ *              Build: mpicxx -O2 -fopenmp mpiLife.cpp -o mpiLife
+ *              Run:   mpirun -np 4 ./mpiLife --size 1000x1000 --generations 100 --verify
+ ********************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <mpi.h>
+#include <omp.h>
+
+#include "lifeGrid.h"
+#include "tiledLife.h"
+
+using namespace std;
+
+// Center 10x10 block of live cells, clipped on small grids (matches initializeGrid in main.cpp)
+bool initiallyAlive(int i, int j, int rows, int cols)
+{
+    return i >= max(0, rows / 2 - 5) && i < min(rows, rows / 2 + 5) && j >= max(0, cols / 2 - 5) && j < min(cols, cols / 2 + 5);
+}
+
+// Splitting n cells into parts nearly equal blocks; the first n % parts blocks get one extra.
+void blockRange(int n, int parts, int index, int &begin, int &count)
+{
+    count = n / parts + (index < n % parts);
+    begin = index * (n / parts) + min(index, n % parts);
+}
+
+// One rank's share of the distributed grid, with its neighbors in the periodic Cartesian communicator.
+struct Domain
+{
+    MPI_Comm comm = MPI_COMM_NULL;
+
+    int dims[2] = {0, 0};
+    int coords[2] = {0, 0};
+    int globalRows = 0, globalCols = 0;
+    int rowBegin = 0, colBegin = 0;
+
+    int north = 0, south = 0, west = 0, east = 0;
+    int northWest = 0, northEast = 0, southWest = 0, southEast = 0;
+
+    MPI_Datatype column = MPI_DATATYPE_NULL;  // One cell per row, strided by the grid pitch
+};
+
+// Building the Cartesian communicator and locating this rank's block and its eight neighbors.
+Domain makeDomain(MPI_Comm parent, int rows, int cols)
+{
+    Domain d;
+
+    int size;
+    int periods[2] = {1, 1};
+
+    MPI_Comm_size(parent, &size);
+    MPI_Dims_create(size, 2, d.dims);
+    MPI_Cart_create(parent, 2, d.dims, periods, 1, &d.comm);
+
+    int rank;
+
+    MPI_Comm_rank(d.comm, &rank);
+    MPI_Cart_coords(d.comm, rank, 2, d.coords);
+
+    d.globalRows = rows;
+    d.globalCols = cols;
+
+    MPI_Cart_shift(d.comm, 0, 1, &d.north, &d.south);
+    MPI_Cart_shift(d.comm, 1, 1, &d.west, &d.east);
+
+    auto neighbor = [&](int dr, int dc) {
+        int c[2] = {d.coords[0] + dr, d.coords[1] + dc}, r;
+
+        MPI_Cart_rank(d.comm, c, &r);
+
+        return r;
+    };
+
+    d.northWest = neighbor(-1, -1);
+    d.northEast = neighbor(-1, 1);
+    d.southWest = neighbor(1, -1);
+    d.southEast = neighbor(1, 1);
+
+    return d;
+}
+
+void freeDomain(Domain &d)
+{
+    if (d.column != MPI_DATATYPE_NULL)
+        MPI_Type_free(&d.column);
+    if (d.comm != MPI_COMM_NULL)
+        MPI_Comm_free(&d.comm);
+}
+
+// Posting the non-blocking exchange of edges and corners into the ghost border of grid (8 receives, 8 sends).
+void startHaloExchange(Domain &d, LifeGrid &grid, MPI_Request *requests)
+{
+    const int r = grid.rows, c = grid.cols;
+
+    // Tags name the direction of travel, so a rank that is its own neighbor still matches correctly
+    enum { toSouth, toNorth, toEast, toWest, toSouthEast, toSouthWest, toNorthEast, toNorthWest };
+
+    int n = 0;
+
+    MPI_Irecv(grid.row(-1), c, MPI_UNSIGNED_CHAR, d.north, toSouth, d.comm, &requests[n++]);
+    MPI_Irecv(grid.row(r), c, MPI_UNSIGNED_CHAR, d.south, toNorth, d.comm, &requests[n++]);
+    MPI_Irecv(grid.row(0) - 1, 1, d.column, d.west, toEast, d.comm, &requests[n++]);
+    MPI_Irecv(grid.row(0) + c, 1, d.column, d.east, toWest, d.comm, &requests[n++]);
+    MPI_Irecv(grid.row(-1) - 1, 1, MPI_UNSIGNED_CHAR, d.northWest, toSouthEast, d.comm, &requests[n++]);
+    MPI_Irecv(grid.row(-1) + c, 1, MPI_UNSIGNED_CHAR, d.northEast, toSouthWest, d.comm, &requests[n++]);
+    MPI_Irecv(grid.row(r) - 1, 1, MPI_UNSIGNED_CHAR, d.southWest, toNorthEast, d.comm, &requests[n++]);
+    MPI_Irecv(grid.row(r) + c, 1, MPI_UNSIGNED_CHAR, d.southEast, toNorthWest, d.comm, &requests[n++]);
+
+    MPI_Isend(grid.row(r - 1), c, MPI_UNSIGNED_CHAR, d.south, toSouth, d.comm, &requests[n++]);
+    MPI_Isend(grid.row(0), c, MPI_UNSIGNED_CHAR, d.north, toNorth, d.comm, &requests[n++]);
+    MPI_Isend(grid.row(0) + c - 1, 1, d.column, d.east, toEast, d.comm, &requests[n++]);
+    MPI_Isend(grid.row(0), 1, d.column, d.west, toWest, d.comm, &requests[n++]);
+    MPI_Isend(grid.row(r - 1) + c - 1, 1, MPI_UNSIGNED_CHAR, d.southEast, toSouthEast, d.comm, &requests[n++]);
+    MPI_Isend(grid.row(r - 1), 1, MPI_UNSIGNED_CHAR, d.southWest, toSouthWest, d.comm, &requests[n++]);
+    MPI_Isend(grid.row(0) + c - 1, 1, MPI_UNSIGNED_CHAR, d.northEast, toNorthEast, d.comm, &requests[n++]);
+    MPI_Isend(grid.row(0), 1, MPI_UNSIGNED_CHAR, d.northWest, toNorthWest, d.comm, &requests[n++]);
+}
+
+// Running the distributed simulation; returns the slowest rank's time in seconds (on every rank).
+double runDistributed(Domain &d, LifeGrid &current, int generations)
+{
+    const int r = current.rows, c = current.cols;
+
+    LifeGrid next(r, c);
+    MPI_Request requests[16];
+
+    MPI_Barrier(d.comm);
+
+    double start = MPI_Wtime();
+
+    for (int gen = 0; gen < generations; gen++)
+    {
+        startHaloExchange(d, current, requests);
+
+        // Interior: rows and columns whose neighbors are all local
+        #pragma omp parallel for schedule(static)
+        for (int i = 1; i < r - 1; i++)
+            updateLifeSpan(current, next, i, 1, c - 1);
+
+        MPI_Waitall(16, requests, MPI_STATUSES_IGNORE);
+
+        // Boundary: first and last row, then first and last column of the rows in between
+        updateLifeSpan(current, next, 0, 0, c);
+        updateLifeSpan(current, next, r - 1, 0, c);
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 1; i < r - 1; i++)
+        {
+            updateLifeSpan(current, next, i, 0, 1);
+            updateLifeSpan(current, next, i, c - 1, c);
+        }
+
+        current.swap(next);
+    }
+
+    double elapsed = MPI_Wtime() - start, slowest;
+
+    MPI_Allreduce(&elapsed, &slowest, 1, MPI_DOUBLE, MPI_MAX, d.comm);
+
+    return slowest;
+}
+
+// Allocating and seeding this rank's block of a rows x cols grid; false if some block would be empty.
+bool setupBlock(Domain &d, LifeGrid &block)
+{
+    if (d.globalRows < d.dims[0] || d.globalCols < d.dims[1])
+        return false;
+
+    int localRows, localCols;
+
+    blockRange(d.globalRows, d.dims[0], d.coords[0], d.rowBegin, localRows);
+    blockRange(d.globalCols, d.dims[1], d.coords[1], d.colBegin, localCols);
+
+    // LifeGrid zeroes its rows with the same static split the interior update uses (first touch)
+    LifeGrid local(localRows, localCols);
+
+    for (int i = 0; i < localRows; i++)
+    {
+        for (int j = 0; j < localCols; j++)
+            local.row(i)[j] = initiallyAlive(d.rowBegin + i, d.colBegin + j, d.globalRows, d.globalCols);
+    }
+
+    block.swap(local);
+
+    MPI_Type_vector(localRows, 1, block.pitch, MPI_UNSIGNED_CHAR, &d.column);
+    MPI_Type_commit(&d.column);
+
+    return true;
+}
+
+// Collecting every block on rank 0 of the domain (other ranks return an empty grid).
+vector<vector<char>> gatherGrid(Domain &d, const LifeGrid &block)
+{
+    int rank, size;
+
+    MPI_Comm_rank(d.comm, &rank);
+    MPI_Comm_size(d.comm, &size);
+
+    vector<unsigned char> packed((size_t)block.rows * block.cols);
+
+    for (int i = 0; i < block.rows; i++)
+        memcpy(&packed[(size_t)i * block.cols], block.row(i), block.cols);
+
+    if (rank != 0)
+    {
+        MPI_Send(packed.data(), (int)packed.size(), MPI_UNSIGNED_CHAR, 0, 0, d.comm);
+
+        return {};
+    }
+
+    vector<vector<char>> grid(d.globalRows, vector<char>(d.globalCols, '.'));
+
+    for (int source = 0; source < size; source++)
+    {
+        int coords[2], rowBegin, rowCount, colBegin, colCount;
+
+        MPI_Cart_coords(d.comm, source, 2, coords);
+        blockRange(d.globalRows, d.dims[0], coords[0], rowBegin, rowCount);
+        blockRange(d.globalCols, d.dims[1], coords[1], colBegin, colCount);
+
+        vector<unsigned char> incoming((size_t)rowCount * colCount);
+
+        if (source == 0)
+            incoming = packed;
+        else
+            MPI_Recv(incoming.data(), (int)incoming.size(), MPI_UNSIGNED_CHAR, source, 0, d.comm, MPI_STATUS_IGNORE);
+
+        for (int i = 0; i < rowCount; i++)
+        {
+            for (int j = 0; j < colCount; j++)
+            {
+                if (incoming[(size_t)i * colCount + j])
+                    grid[rowBegin + i][colBegin + j] = '*';
+            }
+        }
+    }
+
+    return grid;
+}
+
+// Serial reference: the same loop as gameOfLifeSerial in main.cpp.
+vector<vector<char>> serialReference(int rows, int cols, int generations)
+{
+    LifeGrid current(rows, cols);
+    LifeGrid next(rows, cols);
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+            current.row(i)[j] = initiallyAlive(i, j, rows, cols);
+    }
+
+    for (int gen = 0; gen < generations; gen++)
+    {
+        current.refreshGhosts();
+
+        for (int i = 0; i < rows; i++)
+            updateLifeRow(current, next, i);
+
+        current.swap(next);
+    }
+
+    return toCharGrid(current);
+}
+
+struct RunResult
+{
+    bool ok = false;
+    bool verified = true;
+    int dims[2] = {0, 0};
+    double seconds = 0;
+};
+
+// Running rows x cols for the given generations on all ranks of comm, optionally verifying on rank 0.
+RunResult simulate(MPI_Comm comm, int rows, int cols, int generations, bool verify)
+{
+    RunResult result;
+    Domain d = makeDomain(comm, rows, cols);
+    LifeGrid block;
+
+    result.dims[0] = d.dims[0];
+    result.dims[1] = d.dims[1];
+
+    if (!setupBlock(d, block))
+    {
+        freeDomain(d);
+
+        return result;
+    }
+
+    result.ok = true;
+    result.seconds = runDistributed(d, block, generations);
+
+    if (verify)
+    {
+        vector<vector<char>> grid = gatherGrid(d, block);
+        int rank, match = 1;
+
+        MPI_Comm_rank(d.comm, &rank);
+
+        if (rank == 0)
+            match = grid == serialReference(rows, cols, generations);
+
+        MPI_Bcast(&match, 1, MPI_INT, 0, d.comm);
+
+        result.verified = match != 0;
+    }
+
+    freeDomain(d);
+
+    return result;
+}
+
+// Strong scaling (fixed global grid) and weak scaling (fixed block per rank) over 1, 2, 4, ... ranks.
+bool runScaling(int worldRank, int worldSize, int rows, int cols, int generations, bool verify)
+{
+    vector<int> counts;
+
+    for (int p = 1; p < worldSize; p *= 2)
+        counts.push_back(p);
+
+    counts.push_back(worldSize);
+
+    bool allVerified = true;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        bool weak = pass == 1;
+        double baseline = 0;
+
+        if (worldRank == 0)
+        {
+            cout << "> " << (weak ? "Weak" : "Strong") << " scaling (" << (weak ? "block per rank " : "grid ") << rows << "x" << cols
+                 << ", " << generations << " generations, " << omp_get_max_threads() << " threads per rank):" << endl;
+            cout << "  ranks   dims        grid             seconds     cell-updates/s   efficiency  verify" << endl;
+        }
+
+        for (int p : counts)
+        {
+            // Ranks outside the first p sit this run out
+            MPI_Comm sub;
+
+            MPI_Comm_split(MPI_COMM_WORLD, worldRank < p ? 0 : MPI_UNDEFINED, worldRank, &sub);
+
+            if (sub != MPI_COMM_NULL)
+            {
+                int dims[2] = {0, 0};
+
+                MPI_Dims_create(p, 2, dims);
+
+                int runRows = weak ? rows * dims[0] : rows;
+                int runCols = weak ? cols * dims[1] : cols;
+
+                RunResult result = simulate(sub, runRows, runCols, generations, verify);
+
+                if (worldRank == 0)
+                {
+                    if (p == 1)
+                        baseline = result.seconds;
+
+                    double efficiency = result.seconds > 0 ? (weak ? baseline / result.seconds : baseline / (p * result.seconds)) : 0;
+                    double rate = result.seconds > 0 ? (double)runRows * runCols * generations / result.seconds : 0;
+                    string grid = to_string(runRows) + "x" + to_string(runCols);
+                    string dimText = to_string(result.dims[0]) + "x" + to_string(result.dims[1]);
+
+                    cout << "  " << setw(5) << p << "   " << left << setw(10) << dimText << "  " << setw(15) << grid << right
+                         << "  " << setw(10) << fixed << setprecision(5) << result.seconds << "  " << setw(15) << scientific
+                         << setprecision(3) << rate << "  " << setw(10) << fixed << setprecision(3) << efficiency << "  "
+                         << (!result.ok ? "skipped" : !verify ? "-" : result.verified ? "pass" : "FAIL") << endl;
+
+                    cout.unsetf(ios::floatfield);
+                }
+
+                allVerified = allVerified && (!result.ok || result.verified);
+
+                MPI_Comm_free(&sub);
+            }
+
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+
+        if (worldRank == 0)
+            cout << endl;
+    }
+
+    int local = allVerified, global;
+
+    MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+
+    return global != 0;
+}
+
+int main(int argc, char* argv[])
+{
+    int provided;
+
+    // Only the main thread of each rank calls MPI
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+
+    int rank, size;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // --size RxC / --generations G: global grid (or per-rank block for weak scaling) and generation count
+    // --verify: gathering the grid on rank 0 and comparing it with the serial engine
+    // --scaling: strong- and weak-scaling sweeps over 1, 2, 4, ... of the launched ranks
+    int rows = 100, cols = 100, generations = 100;
+    bool verify = false, scaling = false, valid = true;
+
+    for (int a = 1; a < argc && valid; a++)
+    {
+        if (string(argv[a]) == "--size" && a + 1 < argc)
+            valid = sscanf(argv[++a], "%dx%d", &rows, &cols) == 2 && rows > 0 && cols > 0;
+        else if (string(argv[a]) == "--generations" && a + 1 < argc)
+        {
+            generations = atoi(argv[++a]);
+            valid = generations >= 0;
+        }
+        else if (string(argv[a]) == "--verify")
+            verify = true;
+        else if (string(argv[a]) == "--scaling")
+            scaling = true;
+        else
+            valid = false;
+    }
+
+    if (!valid)
+    {
+        if (rank == 0)
+            cout << "Usage: mpirun -np N " << argv[0] << " [--size RxC] [--generations G] [--verify] [--scaling]" << endl;
+
+        MPI_Finalize();
+
+        return 1;
+    }
+
+    if (provided < MPI_THREAD_FUNNELED && rank == 0)
+        cerr << "Warning: the MPI library does not support MPI_THREAD_FUNNELED." << endl;
+
+    bool passed = true;
+
+    if (scaling)
+        passed = runScaling(rank, size, rows, cols, generations, verify);
+    else
+    {
+        RunResult result = simulate(MPI_COMM_WORLD, rows, cols, generations, verify);
+
+        if (rank == 0)
+        {
+            if (!result.ok)
+                cout << "Grid " << rows << "x" << cols << " is smaller than the " << result.dims[0] << "x" << result.dims[1] << " process grid." << endl;
+            else
+            {
+                cout << "> " << size << " ranks (" << result.dims[0] << "x" << result.dims[1] << "), " << omp_get_max_threads()
+                     << " threads per rank, " << rows << "x" << cols << " x " << generations << " generations:" << endl;
+                cout << "-> Time: " << result.seconds << " seconds, "
+                     << (result.seconds > 0 ? (double)rows * cols * generations / result.seconds : 0) << " cell-updates/s." << endl;
+
+                if (verify)
+                    cout << "-> Verification against the serial engine: " << (result.verified ? "pass" : "FAIL") << endl;
+            }
+        }
+
+        passed = result.ok && result.verified;
+    }
+
+    MPI_Finalize();
+
+    return passed ? 0 : 1;
+}
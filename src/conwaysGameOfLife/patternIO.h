@@ -0,0 +1,277 @@
+/********************************************************************
+ * File:        patternIO.h
+ *
+ * Description: Readers for the two common Life pattern formats, and a
+ *              plaintext writer for saving grids:
+ *
+ *              - Plaintext (.cells): '!' comment lines, then one line per
+ *                row with 'O' (or '*') for live and '.' for dead cells.
+ *              - RLE (.rle): '#' comment lines, a "x = W, y = H[, rule =
+ *                B3/S23]" header, then <count><tag> runs where 'b' is dead,
+ *                'o' (or any other letter) is live, '$' ends a row and '!'
+ *                ends the pattern.
+ *
+ *              Patterns are placed in the center of the grid.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lifeGrid.h"
+
+struct LifePattern
+{
+    int rows = 0;
+    int cols = 0;
+
+    std::vector<std::vector<uint8_t>> cells;  // rows x cols, 1 = alive
+};
+
+inline void setPatternCell(LifePattern& pattern, int i, int j)
+{
+    if (i >= (int)pattern.cells.size())
+        pattern.cells.resize(i + 1);
+    if (j >= (int)pattern.cells[i].size())
+        pattern.cells[i].resize(j + 1, 0);
+
+    pattern.cells[i][j] = 1;
+    pattern.rows = std::max(pattern.rows, i + 1);
+    pattern.cols = std::max(pattern.cols, j + 1);
+}
+
+// Padding every row to the full width so cells[i][j] is valid for the whole bounding box.
+inline void finishPattern(LifePattern& pattern)
+{
+    pattern.cells.resize(pattern.rows);
+
+    for (auto& row : pattern.cells)
+        row.resize(pattern.cols, 0);
+}
+
+inline bool parseCells(std::istream& in, LifePattern& pattern, std::string& error)
+{
+    std::string line;
+    int i = 0;
+
+    while (std::getline(in, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        if (!line.empty() && line[0] == '!')
+            continue;
+
+        for (int j = 0; j < (int)line.size(); j++)
+        {
+            char ch = line[j];
+
+            if (ch == 'O' || ch == '*')
+                setPatternCell(pattern, i, j);
+            else if (ch != '.' && !isspace((unsigned char)ch))
+            {
+                error = "unexpected character '" + std::string(1, ch) + "' in row " + std::to_string(i + 1);
+
+                return false;
+            }
+        }
+
+        // Empty lines are rows of dead cells; they count toward the height
+        pattern.rows = std::max(pattern.rows, i + 1);
+        i++;
+    }
+
+    finishPattern(pattern);
+
+    return true;
+}
+
+// Accepting only Conway's rule, in B/S or S/B notation.
+inline bool isConwayRule(std::string rule)
+{
+    std::string compact;
+
+    for (char ch : rule)
+    {
+        if (!isspace((unsigned char)ch))
+            compact += (char)toupper((unsigned char)ch);
+    }
+
+    return compact == "B3/S23" || compact == "S23/B3" || compact == "23/3";
+}
+
+inline bool parseRle(std::istream& in, LifePattern& pattern, std::string& error)
+{
+    std::string line, body;
+    bool haveHeader = false;
+    int width = 0, height = 0;
+
+    while (std::getline(in, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        if (!haveHeader)
+        {
+            // "x = 3, y = 3, rule = B3/S23"
+            std::stringstream fields(line);
+            std::string field;
+
+            while (std::getline(fields, field, ','))
+            {
+                size_t eq = field.find('=');
+
+                if (eq == std::string::npos)
+                    continue;
+
+                std::string key = field.substr(0, eq), value = field.substr(eq + 1);
+
+                key.erase(std::remove_if(key.begin(), key.end(), ::isspace), key.end());
+
+                if (key == "x")
+                    width = atoi(value.c_str());
+                else if (key == "y")
+                    height = atoi(value.c_str());
+                else if (key == "rule" && !isConwayRule(value))
+                {
+                    error = "unsupported rule \"" + value + "\" (only B3/S23 is simulated)";
+
+                    return false;
+                }
+            }
+
+            haveHeader = true;
+
+            continue;
+        }
+
+        body += line;
+    }
+
+    if (!haveHeader)
+    {
+        error = "missing \"x = ..., y = ...\" header";
+
+        return false;
+    }
+
+    int i = 0, j = 0, count = 0;
+
+    for (char ch : body)
+    {
+        if (isdigit((unsigned char)ch))
+        {
+            count = count * 10 + (ch - '0');
+
+            continue;
+        }
+
+        int run = count > 0 ? count : 1;
+
+        count = 0;
+
+        if (ch == '!')
+            break;
+        else if (ch == '$')
+        {
+            i += run;
+            j = 0;
+        }
+        else if (ch == 'b' || ch == '.')
+            j += run;
+        else if (isalpha((unsigned char)ch))
+        {
+            for (int k = 0; k < run; k++)
+                setPatternCell(pattern, i, j++);
+        }
+        else if (!isspace((unsigned char)ch))
+        {
+            error = "unexpected character '" + std::string(1, ch) + "' in the pattern body";
+
+            return false;
+        }
+    }
+
+    // The header box wins over the live-cell bounding box (trailing dead rows and columns)
+    pattern.rows = std::max(pattern.rows, height);
+    pattern.cols = std::max(pattern.cols, width);
+
+    finishPattern(pattern);
+
+    return true;
+}
+
+// Loading a .rle or .cells file (chosen by extension, RLE for anything but .cells / .txt).
+inline bool loadPattern(const std::string& path, LifePattern& pattern, std::string& error)
+{
+    std::ifstream in(path);
+
+    if (!in)
+    {
+        error = "cannot open " + path;
+
+        return false;
+    }
+
+    pattern = LifePattern();
+
+    auto endsWith = [&](const std::string& suffix) {
+        return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+
+    bool ok = endsWith(".cells") || endsWith(".txt") ? parseCells(in, pattern, error) : parseRle(in, pattern, error);
+
+    if (!ok)
+        error = path + ": " + error;
+
+    return ok;
+}
+
+// Writing the pattern into the center of grid (cleared first); false if it does not fit.
+inline bool placePattern(const LifePattern& pattern, LifeGrid& grid)
+{
+    if (pattern.rows > grid.rows || pattern.cols > grid.cols)
+        return false;
+
+    int top = (grid.rows - pattern.rows) / 2, left = (grid.cols - pattern.cols) / 2;
+
+    for (int i = 0; i < grid.rows; i++)
+        memset(grid.row(i), 0, grid.cols);
+
+    for (int i = 0; i < pattern.rows; i++)
+    {
+        for (int j = 0; j < pattern.cols; j++)
+            grid.row(top + i)[left + j] = pattern.cells[i][j];
+    }
+
+    return true;
+}
+
+// Saving a '*' / '.' char grid as a plaintext .cells file.
+inline bool saveCells(const std::string& path, const std::vector<std::vector<char>>& grid)
+{
+    std::ofstream out(path);
+
+    out << "!Name: " << path << "\n";
+
+    for (const auto& row : grid)
+    {
+        for (char cell : row)
+            out << (cell == '*' ? 'O' : '.');
+
+        out << "\n";
+    }
+
+    return (bool)out;
+}
@@ -0,0 +1,140 @@
+/********************************************************************
+ * File:        temporalLife.h
+ *
+ * Description: Temporally blocked Game of Life engine (overlapped tiling).
+ *              Every tile is copied with a halo of width k into a
+ *              thread-local scratch buffer and advanced k generations
+ *              there; each generation shrinks the valid region by one
+ *              cell, so after k steps exactly the tile itself is correct
+ *              and is written to the next grid. The grid is read and
+ *              written once per k generations, and threads synchronize
+ *              once per block (the barrier ending the tile loop; each
+ *              thread swaps its own pointers to the two grids) instead of
+ *              once per generation, at the cost of recomputing the halo
+ *              cells.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <omp.h>
+
+#include "lifeGrid.h"
+
+// One generation over rows/cols [border, extent - border) of a width-wide scratch buffer.
+inline void stepScratch(const uint8_t* __restrict in, uint8_t* __restrict out, int width, int height, int border)
+{
+    for (int i = border; i < height - border; i++)
+    {
+        const uint8_t* up = in + (size_t)(i - 1) * width;
+        const uint8_t* mid = in + (size_t)i * width;
+        const uint8_t* down = in + (size_t)(i + 1) * width;
+
+        uint8_t* o = out + (size_t)i * width;
+
+        for (int j = border; j < width - border; j++)
+        {
+            int liveNeighbors = up[j - 1] + up[j] + up[j + 1]
+                              + mid[j - 1]        + mid[j + 1]
+                              + down[j - 1] + down[j] + down[j + 1];
+
+            o[j] = (uint8_t)((liveNeighbors == 3) | (mid[j] & (liveNeighbors == 2)));
+        }
+    }
+}
+
+// Advancing grid by the given number of generations, depth generations per tile visit. With a hook, every
+// block runs in its own parallel region and the hook runs between them (with the whole team free again).
+inline void temporalLifeRun(LifeGrid& grid, int generations, int tileSize, int depth, const LifeSyncHook& afterBlock = nullptr)
+{
+    const int rows = grid.rows, cols = grid.cols;
+    const int tileRows = (rows + tileSize - 1) / tileSize;
+    const int tileCols = (cols + tileSize - 1) / tileSize;
+    const int tiles = tileRows * tileCols;
+
+    LifeGrid next(rows, cols);
+
+    // Toroidal source index of every row / column the halos can reach, offset by depth
+    std::vector<int> rowMap(rows + 2 * depth), colMap(cols + 2 * depth);
+
+    for (int r = 0; r < rows + 2 * depth; r++)
+        rowMap[r] = ((r - depth) % rows + rows) % rows;
+    for (int c = 0; c < cols + 2 * depth; c++)
+        colMap[c] = ((c - depth) % cols + cols) % cols;
+
+    const int segment = afterBlock ? depth : std::max(generations, 1);
+
+    for (int begin = 0; begin < generations; begin += segment)
+    {
+        const int end = std::min(generations, begin + segment);
+
+        #pragma omp parallel
+        {
+            const int extent = tileSize + 2 * depth;
+
+            // Private views of the two grids, swapped by every thread after each block: the barrier that ends
+            // the tile loop is then the only synchronization per block
+            LifeGrid* current = &grid;
+            LifeGrid* target = &next;
+
+            std::vector<uint8_t> bufferA((size_t)extent * extent), bufferB((size_t)extent * extent);
+
+            for (int done = begin; done < end; done += depth)
+            {
+                const int steps = std::min(depth, end - done);
+
+                #pragma omp for schedule(static)
+                for (int t = 0; t < tiles; t++)
+                {
+                    const int rowBegin = (t / tileCols) * tileSize, colBegin = (t % tileCols) * tileSize;
+                    const int height = std::min(tileSize, rows - rowBegin) + 2 * steps;
+                    const int width = std::min(tileSize, cols - colBegin) + 2 * steps;
+                    const int skew = depth - steps;  // Map offset when the last block is shorter
+
+                    // Loading the tile and its halo of width steps
+                    for (int i = 0; i < height; i++)
+                    {
+                        const uint8_t* src = current->row(rowMap[rowBegin + skew + i]);
+                        const int* cmap = &colMap[colBegin + skew];
+
+                        uint8_t* dst = &bufferA[(size_t)i * width];
+
+                        // Contiguous unless the halo wraps around a grid edge
+                        if (cmap[width - 1] - cmap[0] == width - 1)
+                            memcpy(dst, src + cmap[0], width);
+                        else
+                        {
+                            for (int j = 0; j < width; j++)
+                                dst[j] = src[cmap[j]];
+                        }
+                    }
+
+                    uint8_t* in = bufferA.data();
+                    uint8_t* out = bufferB.data();
+
+                    for (int s = 1; s <= steps; s++)
+                    {
+                        stepScratch(in, out, width, height, s);
+                        std::swap(in, out);
+                    }
+
+                    // Only the tile itself is valid after steps generations
+                    for (int i = steps; i < height - steps; i++)
+                        memcpy(target->row(rowBegin + i - steps) + colBegin, in + (size_t)i * width + steps, width - 2 * steps);
+                }
+
+                std::swap(current, target);
+            }
+        }
+
+        // An odd number of blocks leaves the result in next
+        if (((end - begin + depth - 1) / depth) % 2 == 1)
+            grid.swap(next);
+
+        if (afterBlock && afterBlock(grid, end, end - begin))
+            break;
+    }
+}
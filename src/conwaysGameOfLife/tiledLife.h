@@ -0,0 +1,133 @@
+/********************************************************************
+ * File:        tiledLife.h
+ *
+ * Description: Active-tile Game of Life engine. The grid is divided into
+ *              square tiles and every tile records whether any of its cells
+ *              changed in the last generation. A tile is recomputed only if
+ *              it or one of its eight (toroidal) neighbor tiles changed;
+ *              otherwise its cells cannot change, and the back buffer
+ *              already holds the right values. Active tiles are handed out
+ *              dynamically across threads.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <omp.h>
+
+#include "lifeGrid.h"
+
+struct TiledLifeStats
+{
+    int tiles = 0;
+
+    std::vector<int> activeTiles;  // Active tile count for every generation
+};
+
+// Updating columns [colBegin, colEnd) of interior row i; returns true if any cell changed.
+inline bool updateLifeSpan(const LifeGrid& current, LifeGrid& next, int i, int colBegin, int colEnd)
+{
+    const uint8_t* up = current.row(i - 1);
+    const uint8_t* mid = current.row(i);
+    const uint8_t* down = current.row(i + 1);
+
+    uint8_t* out = next.row(i);
+    uint8_t changed = 0;
+
+    for (int j = colBegin; j < colEnd; j++)
+    {
+        int liveNeighbors = up[j - 1] + up[j] + up[j + 1]
+                          + mid[j - 1]        + mid[j + 1]
+                          + down[j - 1] + down[j] + down[j + 1];
+
+        uint8_t cell = (uint8_t)((liveNeighbors == 3) | (mid[j] & (liveNeighbors == 2)));
+
+        changed |= cell ^ mid[j];
+        out[j] = cell;
+    }
+
+    return changed != 0;
+}
+
+// Advancing grid by the given number of generations, recomputing only active tiles.
+inline void tiledLifeRun(LifeGrid& grid, int generations, int tileSize, TiledLifeStats& stats,
+                         const LifeSyncHook& afterGeneration = nullptr)
+{
+    const int rows = grid.rows, cols = grid.cols;
+    const int tileRows = (rows + tileSize - 1) / tileSize;
+    const int tileCols = (cols + tileSize - 1) / tileSize;
+    const int tiles = tileRows * tileCols;
+
+    // Both buffers start equal so skipped tiles are correct in either one
+    LifeGrid next(rows, cols);
+
+    for (int i = 0; i < rows; i++)
+        memcpy(next.row(i), grid.row(i), cols);
+
+    // Every tile counts as changed before the first generation
+    std::vector<uint8_t> changedPrev(tiles, 1), changedNow(tiles, 0);
+    std::vector<int> active;
+
+    active.reserve(tiles);
+
+    stats.tiles = tiles;
+    stats.activeTiles.clear();
+
+    for (int gen = 0; gen < generations; gen++)
+    {
+        active.clear();
+
+        for (int tr = 0; tr < tileRows; tr++)
+        {
+            for (int tc = 0; tc < tileCols; tc++)
+            {
+                bool wake = false;
+
+                for (int dr = -1; dr <= 1 && !wake; dr++)
+                {
+                    for (int dc = -1; dc <= 1 && !wake; dc++)
+                    {
+                        int nr = (tr + dr + tileRows) % tileRows;
+                        int nc = (tc + dc + tileCols) % tileCols;
+
+                        wake = changedPrev[nr * tileCols + nc] != 0;
+                    }
+                }
+
+                if (wake)
+                    active.push_back(tr * tileCols + tc);
+            }
+        }
+
+        stats.activeTiles.push_back((int)active.size());
+
+        std::fill(changedNow.begin(), changedNow.end(), 0);
+
+        grid.refreshGhosts();
+
+        const int activeCount = (int)active.size();
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int k = 0; k < activeCount; k++)
+        {
+            int t = active[k];
+            int rowBegin = (t / tileCols) * tileSize, rowEnd = std::min(rows, rowBegin + tileSize);
+            int colBegin = (t % tileCols) * tileSize, colEnd = std::min(cols, colBegin + tileSize);
+            bool changed = false;
+
+            for (int i = rowBegin; i < rowEnd; i++)
+                changed |= updateLifeSpan(grid, next, i, colBegin, colEnd);
+
+            changedNow[t] = changed;
+        }
+
+        grid.swap(next);
+        changedPrev.swap(changedNow);
+
+        if (afterGeneration && afterGeneration(grid, gen + 1, 1))
+            break;
+    }
+}
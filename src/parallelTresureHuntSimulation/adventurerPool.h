@@ -0,0 +1,205 @@
+/********************************************************************
+ * File:        adventurerPool.h
+ *
+ * Description: Lifecycle management for the task engine's adventurers.
+ *
+ *              - StatePool recycles adventurer states (and the memory of
+ *                their visited sets) through per-thread free lists, so a
+ *                spawn normally allocates nothing and needs no lock.
+ *              - LifecycleManager caps the number of live adventurers.
+ *                A spawn beyond the cap goes to a pending queue instead of
+ *                becoming a task; an adventurer task that finishes picks
+ *                up pending spawns before giving its slot back, so the
+ *                number of tasks stays bounded during resurrection storms.
+ *                The queue and the release of a slot share one mutex, so a
+ *                deferred spawn is never stranded: whoever defers it saw
+ *                a full cap, and every live adventurer checks the queue
+ *                before leaving.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <omp.h>
+
+struct SpawnRequest
+{
+    int id;
+    uint64_t stream;
+};
+
+struct LifecycleStats
+{
+    long started = 0;      // Adventurers run (initial and spawned)
+    long deferred = 0;     // Spawns that waited in the pending queue
+    long peakLive = 0;
+    long peakPending = 0;
+    long peakQueuedTasks = 0;  // Most tasks created but not yet started
+
+    long acquired = 0;     // States handed out by the pool
+    long reused = 0;       // ... of which were recycled
+};
+
+// Per-thread free lists of State objects (at most keepPerThread kept per thread).
+template <typename State>
+class StatePool
+{
+public:
+    explicit StatePool(int threads, int keepPerThread = 64) : lists(std::max(1, threads)), keep(keepPerThread) {}
+
+    std::unique_ptr<State> acquire()
+    {
+        FreeList& list = lists[slot()];
+
+        list.acquired++;
+
+        if (list.states.empty())
+            return std::unique_ptr<State>(new State());
+
+        std::unique_ptr<State> state = std::move(list.states.back());
+
+        list.states.pop_back();
+        list.reused++;
+
+        return state;
+    }
+
+    void release(std::unique_ptr<State> state)
+    {
+        FreeList& list = lists[slot()];
+
+        if ((int)list.states.size() < keep)
+            list.states.push_back(std::move(state));
+    }
+
+    // Summing the per-thread counters (call outside the parallel region).
+    void addStats(LifecycleStats& stats) const
+    {
+        for (const FreeList& list : lists)
+        {
+            stats.acquired += list.acquired;
+            stats.reused += list.reused;
+        }
+    }
+
+private:
+    struct alignas(64) FreeList
+    {
+        std::vector<std::unique_ptr<State>> states;
+
+        long acquired = 0;
+        long reused = 0;
+    };
+
+    std::vector<FreeList> lists;
+
+    int keep;
+
+    // Threads beyond the pool's size (nested regions) share the last list, which only the
+    // calling thread can reach here because tasks are tied and this is not a scheduling point.
+    size_t slot() const { return std::min((size_t)omp_get_thread_num(), lists.size() - 1); }
+};
+
+class LifecycleManager
+{
+public:
+    // maxLive <= 0 means no cap.
+    explicit LifecycleManager(int maxLive) : cap(maxLive > 0 ? maxLive : INT32_MAX) {}
+
+    // Taking a live slot for a new adventurer; false if the cap is reached (then call defer).
+    bool tryReserve()
+    {
+        int current = live.load(std::memory_order_relaxed);
+
+        while (current < cap)
+        {
+            if (live.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel))
+            {
+                notePeak(peakLive, current + 1);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Queueing a spawn that did not get a slot. Returns true if a slot freed up meanwhile
+    // (the caller then owns it and starts the adventurer itself).
+    bool defer(const SpawnRequest& request)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (tryReserve())
+            return true;
+
+        pending.push_back(request);
+        deferred++;
+        notePeak(peakPending, (long)pending.size());
+
+        return false;
+    }
+
+    // Called by an adventurer task when its adventurer is done: either hands over a pending spawn
+    // (keeping the slot) or gives the slot back.
+    bool finishOrNext(SpawnRequest& next)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!pending.empty())
+        {
+            next = pending.front();
+            pending.pop_front();
+
+            return true;
+        }
+
+        live.fetch_sub(1, std::memory_order_acq_rel);
+
+        return false;
+    }
+
+    // Task queue depth: tasks created and not yet started.
+    void taskCreated() { notePeak(peakQueuedTasks, queuedTasks.fetch_add(1, std::memory_order_relaxed) + 1); }
+    void taskStarted() { queuedTasks.fetch_sub(1, std::memory_order_relaxed); }
+
+    void adventurerStarted() { started.fetch_add(1, std::memory_order_relaxed); }
+
+    void addStats(LifecycleStats& stats) const
+    {
+        stats.started += started;
+        stats.deferred += deferred;
+        stats.peakLive = std::max(stats.peakLive, peakLive.load());
+        stats.peakPending = std::max(stats.peakPending, peakPending.load());
+        stats.peakQueuedTasks = std::max(stats.peakQueuedTasks, peakQueuedTasks.load());
+    }
+
+private:
+    const int cap;
+
+    std::atomic<int> live{0};
+    std::atomic<long> queuedTasks{0};
+    std::atomic<long> started{0};
+
+    std::mutex mutex;
+    std::deque<SpawnRequest> pending;  // Guarded by mutex
+    long deferred = 0;                 // Guarded by mutex
+
+    std::atomic<long> peakLive{0};
+    std::atomic<long> peakPending{0};
+    std::atomic<long> peakQueuedTasks{0};
+
+    static void notePeak(std::atomic<long>& peak, long value)
+    {
+        long current = peak.load(std::memory_order_relaxed);
+
+        while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            ;
+    }
+};
@@ -0,0 +1,205 @@
+/********************************************************************
+ * File:        checkpointBarrier.h
+ *
+ * Description: Epoch-based checkpoint barrier with dynamic membership
+ *              for the task engine. Adventurers join when they start
+ *              running and leave when they stop (deadly trap, boxed in,
+ *              hunt over), and arrive at every checkpoint. An epoch ends
+ *              once every current member has arrived; an arrival can
+ *              wait for that (below-threshold adventurers) or go on, but
+ *              a member arrives at most once per epoch, so one that gets
+ *              to its next checkpoint early waits for the epoch to end.
+ *
+ *              Sense-reversing design: the member count, the arrival
+ *              count and the epoch number (the "sense") share one 64-bit
+ *              word, so joins, leaves and arrivals are single atomic
+ *              updates that cannot race with the end of an epoch, and
+ *              an arrival is one fetch_add. Waiters spin on a separate
+ *              copy of the epoch, which changes once per epoch, instead
+ *              of on the counter line the arrivals write.
+ *
+ *              Only running adventurers are members, at most one per
+ *              thread, so a waiting task never waits for a task that has
+ *              no thread to run on. A member that creates a task leaves
+ *              around the creation: OpenMP may run the new task inline,
+ *              suspending its parent until the child is done.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+struct CheckpointStats
+{
+    long epochs = 0;
+    long arrivals = 0;
+    long waits = 0;             // Arrivals that blocked until their epoch ended
+    long joins = 0;
+
+    double waitSeconds = 0;     // Summed over waits
+    double maxWaitSeconds = 0;
+};
+
+class CheckpointBarrier
+{
+public:
+    // One participant's view of the barrier (owned by the adventurer).
+    struct Member
+    {
+        uint32_t arrivedEpoch = NO_EPOCH;  // Last epoch this member is counted as arrived in
+    };
+
+    // Statistics are kept per OpenMP thread (threads is the largest team the barrier will see).
+    explicit CheckpointBarrier(int threads) : slots(std::max(1, threads)) {}
+
+    void join(Member& member)
+    {
+        member.arrivedEpoch = NO_EPOCH;
+        state.fetch_add(ONE_MEMBER, std::memory_order_acq_rel);
+        slot().joins++;
+    }
+
+    // Leaving, taking back this member's arrival if it already arrived in the current epoch. The epoch
+    // ends here if everyone left is waiting for it.
+    void leave(Member& member)
+    {
+        uint64_t current = state.load(std::memory_order_relaxed);
+        uint64_t next;
+
+        do
+        {
+            next = current - ONE_MEMBER - (epochOf(current) == member.arrivedEpoch ? 1 : 0);
+        }
+        while (!state.compare_exchange_weak(current, next, std::memory_order_acq_rel));
+
+        member.arrivedEpoch = NO_EPOCH;
+        tryAdvance(next);
+    }
+
+    // Arriving at a checkpoint. With wait, returning only once the epoch has ended.
+    void arrive(Member& member, bool wait)
+    {
+        uint32_t epoch = epochOf(state.load(std::memory_order_acquire));
+
+        // Already counted in this epoch: waiting for it to end before arriving in the next one
+        while (epoch == member.arrivedEpoch)
+        {
+            waitFor(epoch);
+            epoch = epochOf(state.load(std::memory_order_acquire));
+        }
+
+        // The epoch cannot end before this member arrives, so the arrival lands in it
+        uint64_t before = state.fetch_add(1, std::memory_order_acq_rel);
+
+        member.arrivedEpoch = epoch;
+        slot().arrivals++;
+
+        if (arrivedOf(before) + 1 == membersOf(before))
+            tryAdvance(before + 1);
+
+        if (wait)
+            waitFor(epoch);
+    }
+
+    // Summing the per-thread counters (call outside the parallel region).
+    CheckpointStats getStats() const
+    {
+        CheckpointStats stats;
+
+        for (const Slot& s : slots)
+        {
+            stats.epochs += s.epochs;
+            stats.arrivals += s.arrivals;
+            stats.waits += s.waits;
+            stats.joins += s.joins;
+            stats.waitSeconds += s.waitSeconds;
+            stats.maxWaitSeconds = std::max(stats.maxWaitSeconds, s.maxWaitSeconds);
+        }
+
+        return stats;
+    }
+
+private:
+    static constexpr uint32_t NO_EPOCH = ~(uint32_t)0;
+    static constexpr uint64_t ONE_MEMBER = (uint64_t)1 << 16;
+
+    // epoch << 32 | members << 16 | arrived (members are running adventurers, at most one per thread)
+    alignas(64) std::atomic<uint64_t> state{0};
+
+    // Copy of the epoch in state, published after each advance; only ever increases
+    alignas(64) std::atomic<uint32_t> published{0};
+
+    struct alignas(64) Slot
+    {
+        long epochs = 0;
+        long arrivals = 0;
+        long waits = 0;
+        long joins = 0;
+
+        double waitSeconds = 0;
+        double maxWaitSeconds = 0;
+    };
+
+    std::vector<Slot> slots;
+
+    static uint32_t epochOf(uint64_t word) { return (uint32_t)(word >> 32); }
+    static uint32_t membersOf(uint64_t word) { return (uint32_t)(word >> 16) & 0xFFFF; }
+    static uint32_t arrivedOf(uint64_t word) { return (uint32_t)word & 0xFFFF; }
+
+    // Threads beyond the barrier's size (nested regions) share the last slot's statistics.
+    Slot& slot() { return slots[std::min((size_t)omp_get_thread_num(), slots.size() - 1)]; }
+
+    // Ending the epoch of word if all its members have arrived (a join in between keeps it open).
+    void tryAdvance(uint64_t word)
+    {
+        const uint32_t epoch = epochOf(word);
+        uint64_t current = state.load(std::memory_order_acquire);
+
+        while (epochOf(current) == epoch && membersOf(current) > 0 && arrivedOf(current) == membersOf(current))
+        {
+            // Next epoch, same members, nobody arrived
+            uint64_t next = ((uint64_t)(epoch + 1) << 32) | (current & ((uint64_t)0xFFFF << 16));
+
+            if (state.compare_exchange_weak(current, next, std::memory_order_acq_rel))
+            {
+                uint32_t seen = published.load(std::memory_order_relaxed);
+
+                while ((int32_t)(epoch + 1 - seen) > 0 && !published.compare_exchange_weak(seen, epoch + 1, std::memory_order_release))
+                    ;
+
+                slot().epochs++;
+
+                return;
+            }
+        }
+    }
+
+    // Blocking until epoch has ended: spinning briefly, then yielding the core (teams are often
+    // larger than the cores they get).
+    void waitFor(uint32_t epoch)
+    {
+        if ((int32_t)(published.load(std::memory_order_acquire) - epoch) > 0)
+            return;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int spins = 0; (int32_t)(published.load(std::memory_order_acquire) - epoch) <= 0; spins++)
+        {
+            if (spins >= 64)
+                std::this_thread::yield();
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Slot& s = slot();
+
+        s.waits++;
+        s.waitSeconds += seconds;
+        s.maxWaitSeconds = std::max(s.maxWaitSeconds, seconds);
+    }
+};
@@ -0,0 +1,310 @@
+/********************************************************************
+ * File:        eventLog.h
+ *
+ * Description: Asynchronous event log for the treasure hunt. Adventurers
+ *              record compact binary events into a ring buffer owned by
+ *              the OpenMP thread they run on (single producer, single
+ *              consumer, no locks); a background drainer thread empties
+ *              the rings, formats the events in batches and writes each
+ *              batch with one call. A full ring drops the event and counts
+ *              it instead of blocking the simulation.
+ *
+ *              Events are filtered by verbosity (1: deaths and spawns,
+ *              2: also treasures, 3: also traps and checkpoint waits) and
+ *              can be sampled (1 of every N per thread). The raw records
+ *              can also be written to a binary trace file:
+ *                "HUNTTRC1" | record size u32 | HuntEvent records...
+ *              Text lines keep the order of each thread, not the global
+ *              order; the trace keeps timestamps for offline sorting.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+enum HuntEventKind : uint8_t { EVENT_TREASURE, EVENT_TRAP, EVENT_RESURRECTION, EVENT_DEADLY_TRAP, EVENT_CHECKPOINT_WAIT };
+
+struct HuntEvent
+{
+    uint64_t nanoseconds;  // Since the log was opened
+    int32_t adventurer;
+    int32_t x, y;
+    int32_t value;         // Treasure / trap value
+    int32_t score;         // Adventurer's score after the event
+    uint16_t thread;
+    uint8_t kind;
+    uint8_t padding = 0;
+};
+
+struct EventLogOptions
+{
+    int level = 3;        // 0 disables the log
+    int sample = 1;       // Keep 1 of every sample events (per thread)
+    int ringEvents = 4096;  // Per-thread ring capacity (rounded up to a power of two)
+
+    std::string tracePath;  // Binary trace output (none if empty)
+};
+
+struct EventLogStats
+{
+    long written = 0;     // Formatted (and traced) by the drainer
+    long dropped = 0;     // Lost to full rings
+    long sampledOut = 0;  // Skipped by sampling
+    long batches = 0;
+};
+
+// Verbosity level an event needs to be logged.
+inline int eventLevel(uint8_t kind)
+{
+    switch (kind)
+    {
+        case EVENT_DEADLY_TRAP:
+        case EVENT_RESURRECTION:
+            return 1;
+        case EVENT_TREASURE:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+// The console line for one event (the wording of the original direct output).
+inline void formatEvent(const HuntEvent& e, std::string& out)
+{
+    char line[160];
+
+    switch (e.kind)
+    {
+        case EVENT_TREASURE:
+            snprintf(line, sizeof(line), "-> Adventurer %d collected treasure at (%d,%d) for +%d points. New score: %d\n",
+                     e.adventurer, e.x, e.y, e.value, e.score);
+            break;
+        case EVENT_TRAP:
+            snprintf(line, sizeof(line), "-> Adventurer %d hit a trap at (%d,%d) for %d points. New score: %d\n",
+                     e.adventurer, e.x, e.y, e.value, e.score);
+            break;
+        case EVENT_RESURRECTION:
+            snprintf(line, sizeof(line), "-> Adventurer %d found a Resurrection Stone at (%d,%d). Spawning new adventurer.\n",
+                     e.adventurer, e.x, e.y);
+            break;
+        case EVENT_DEADLY_TRAP:
+            snprintf(line, sizeof(line), "-> Adventurer %d encountered a Deadly Trap at (%d,%d). Terminating.\n",
+                     e.adventurer, e.x, e.y);
+            break;
+        default:
+            snprintf(line, sizeof(line), "-> Adventurer %d is waiting at checkpoint with low score (%d).\n", e.adventurer, e.score);
+            break;
+    }
+
+    out += line;
+}
+
+class EventLog
+{
+public:
+    // One ring per OpenMP thread (threads is the largest team the log will see).
+    EventLog(const EventLogOptions& logOptions, int threads, FILE* textOutput = stdout)
+        : options(logOptions), text(textOutput), start(std::chrono::steady_clock::now())
+    {
+        size_t capacity = 1;
+
+        while (capacity < (size_t)std::max(2, options.ringEvents))
+            capacity *= 2;
+
+        for (int t = 0; t < threads; t++)
+            rings.emplace_back(new Ring(capacity));
+
+        if (!options.tracePath.empty())
+        {
+            trace = fopen(options.tracePath.c_str(), "wb");
+
+            if (trace)
+            {
+                uint32_t recordSize = sizeof(HuntEvent);
+
+                fwrite("HUNTTRC1", 1, 8, trace);
+                fwrite(&recordSize, sizeof(recordSize), 1, trace);
+            }
+        }
+
+        drainer = std::thread(&EventLog::drainLoop, this);
+    }
+
+    ~EventLog() { close(); }
+
+    bool enabled(uint8_t kind) const { return options.level >= eventLevel(kind); }
+
+    // False if a trace was requested but its file could not be created.
+    bool traceReady() const { return options.tracePath.empty() || trace != NULL; }
+
+    // Recording an event from the calling OpenMP thread; never blocks.
+    void record(uint8_t kind, int adventurer, int x, int y, int value, int score)
+    {
+        if (!enabled(kind))
+            return;
+
+        int thread = omp_get_thread_num();
+
+        if (thread >= (int)rings.size())
+        {
+            droppedElsewhere++;
+
+            return;
+        }
+
+        Ring& ring = *rings[thread];
+
+        if (options.sample > 1 && ring.seen++ % options.sample != 0)
+        {
+            ring.sampledOut++;
+
+            return;
+        }
+
+        const uint64_t head = ring.head.load(std::memory_order_relaxed);
+
+        if (head - ring.tail.load(std::memory_order_acquire) == ring.events.size())
+        {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+
+            return;
+        }
+
+        HuntEvent& e = ring.events[head & (ring.events.size() - 1)];
+
+        e.nanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        e.adventurer = adventurer;
+        e.x = x;
+        e.y = y;
+        e.value = value;
+        e.score = score;
+        e.thread = (uint16_t)thread;
+        e.kind = kind;
+
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    // Draining every ring and stopping the drainer (call once the simulation is done).
+    void close()
+    {
+        if (!drainer.joinable())
+            return;
+
+        stopping = true;
+        drainer.join();
+
+        if (trace)
+        {
+            fclose(trace);
+            trace = NULL;
+        }
+    }
+
+    EventLogStats getStats() const
+    {
+        EventLogStats stats;
+
+        stats.written = written;
+        stats.batches = batches;
+        stats.dropped = droppedElsewhere;
+
+        for (const auto& ring : rings)
+        {
+            stats.dropped += ring->dropped.load();
+            stats.sampledOut += ring->sampledOut;
+        }
+
+        return stats;
+    }
+
+private:
+    struct Ring
+    {
+        explicit Ring(size_t capacity) : events(capacity) {}
+
+        std::vector<HuntEvent> events;
+
+        alignas(64) std::atomic<uint64_t> head{0};  // Written by the owning thread
+        alignas(64) std::atomic<uint64_t> tail{0};  // Written by the drainer
+
+        alignas(64) std::atomic<long> dropped{0};
+        long seen = 0;        // Owner only
+        long sampledOut = 0;  // Owner only (read after the run)
+    };
+
+    EventLogOptions options;
+
+    FILE* text;
+    FILE* trace = NULL;
+
+    std::chrono::steady_clock::time_point start;
+
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<long> droppedElsewhere{0};
+
+    long written = 0;  // Drainer only (read after close)
+    long batches = 0;
+
+    std::thread drainer;
+
+    void drainLoop()
+    {
+        std::string batch;
+        std::vector<HuntEvent> raw;
+
+        for (;;)
+        {
+            // Reading the flag first, so a final pass after it is set sees every event recorded before close()
+            bool last = stopping.load(std::memory_order_acquire);
+
+            batch.clear();
+            raw.clear();
+
+            for (auto& ring : rings)
+            {
+                const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+                const uint64_t head = ring->head.load(std::memory_order_acquire);
+
+                for (uint64_t k = tail; k < head; k++)
+                {
+                    const HuntEvent& e = ring->events[k & (ring->events.size() - 1)];
+
+                    formatEvent(e, batch);
+
+                    if (trace)
+                        raw.push_back(e);
+                }
+
+                ring->tail.store(head, std::memory_order_release);
+                written += (long)(head - tail);
+            }
+
+            if (!batch.empty())
+            {
+                fwrite(batch.data(), 1, batch.size(), text);
+                fflush(text);
+                batches++;
+            }
+
+            if (trace && !raw.empty())
+                fwrite(raw.data(), sizeof(HuntEvent), raw.size(), trace);
+
+            if (last)
+                return;
+
+            if (batch.empty())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
@@ -0,0 +1,48 @@
+/********************************************************************
+ * File:        huntGrid.h
+ *
+ * Description: Grid cells of the treasure hunt, shared by the task engine
+ *              (main.cpp), the lockstep engine (lockstepHunt.h) and the
+ *              sharded engine (shardedHunt.h).
+ ********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "visitedSet.h"
+
+// Enumeration for cell types
+enum CellType { EMPTY, TREASURE, TRAP, RESURRECTION, DEADLY_TRAP };
+
+// Structure for a grid cell
+struct Cell 
+{
+    // Consumable cells (TREASURE, RESURRECTION) are claimed by swapping their type to EMPTY with
+    // compare-and-swap; the adventurer whose swap succeeds is the only one to collect them.
+    std::atomic<CellType> type{EMPTY};
+
+    int value = 0; // For treasure: positive score; for trap: negative penalty; others: 0. Fixed once the grid is built.
+};
+
+// Utility: Check if (x, y) is within grid bounds.
+inline bool inBounds(int x, int y, int N) 
+{
+    return (x >= 0 && x < N && y >= 0 && y < N);
+}
+
+// Utility: Check whether any in-bounds neighbor of (x, y) is still unvisited.
+inline bool hasUnvisitedNeighbor(const VisitedSet &visited, int x, int y, int N)
+{
+    const int dx[4] = {-1, 1, 0, 0};
+    const int dy[4] = {0, 0, -1, 1};
+
+    for (int d = 0; d < 4; d++)
+    {
+        if (inBounds(x + dx[d], y + dy[d], N) && !visited.contains(x + dx[d], y + dy[d]))
+            return true;
+    }
+
+    return false;
+}
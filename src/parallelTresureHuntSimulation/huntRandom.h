@@ -0,0 +1,55 @@
+/********************************************************************
+ * File:        huntRandom.h
+ *
+ * Description: Counter-based random numbers for the treasure hunt. A
+ *              value is a pure function of (run seed, stream key, counter),
+ *              built from the SplitMix64 finalizer, so there is no shared
+ *              generator state: every adventurer draws from its own stream
+ *              and every grid cell from a stream keyed by its index, and a
+ *              given seed reproduces the same values whatever thread ends
+ *              up computing them.
+ ********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+// Stream keys from here up are reserved for grid cells (GRID_STREAMS + i * N + j); adventurers use the keys below.
+const uint64_t GRID_STREAMS = 1ULL << 63;
+
+// SplitMix64 finalizer: a bijective 64-bit mix
+inline uint64_t mixBits(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+// The counter-th value of stream key under seed.
+inline uint64_t counterRandom(uint64_t seed, uint64_t key, uint64_t counter)
+{
+    return mixBits(mixBits(seed ^ mixBits(key + 0x9E3779B97F4A7C15ULL)) + counter * 0x9E3779B97F4A7C15ULL);
+}
+
+// Uniform value in [0, n) from 64 random bits (multiply-shift, bias below 2^-32 for the small n used here).
+inline int boundedRandom(uint64_t bits, int n)
+{
+    return (int)(((bits >> 32) * (uint64_t)n) >> 32);
+}
+
+// One adventurer's stream: successive counters of counterRandom under a fixed (seed, key).
+class RandomStream
+{
+public:
+    RandomStream(uint64_t runSeed = 0, uint64_t streamKey = 0) : seed(runSeed), key(streamKey) {}
+
+    uint64_t next() { return counterRandom(seed, key, counter++); }
+
+    int below(int n) { return boundedRandom(next(), n); }
+
+private:
+    uint64_t seed;
+    uint64_t key;
+    uint64_t counter = 0;
+};
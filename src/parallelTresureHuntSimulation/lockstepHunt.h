@@ -0,0 +1,433 @@
+/********************************************************************
+ * File:        lockstepHunt.h
+ *
+ * Description: Batched treasure hunt engine for very many adventurers.
+ *              Adventurers are stored as struct-of-arrays (position,
+ *              score, moves, stream, active flag, visited set) and advance
+ *              together in rounds instead of running as one OpenMP task
+ *              each. A round has three data-parallel passes:
+ *
+ *              1. Proposal: every adventurer draws a direction from its
+ *                 counter-based stream and bounds-checks the target cell
+ *                 (branch-free, vectorizable).
+ *              2. Move: valid targets are taken; traps and deadly traps
+ *                 apply directly, and landings on a treasure or a
+ *                 resurrection stone register a claim in a hash table
+ *                 that keeps the lowest adventurer index per cell.
+ *              3. Resolution: each claimed cell goes to the adventurer
+ *                 holding it in the table, and losers see an empty cell.
+ *                 Stones spawn new adventurers after the round, in index
+ *                 order.
+ *
+ *              The cell semantics match the task engine. Conflicts go to
+ *              the lowest index, not the fastest thread, so for a given
+ *              seed the result is the same for any thread count.
+ *              Retired adventurers are compacted away once they make up
+ *              half of the arrays.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <omp.h>
+
+#include "huntGrid.h"
+#include "huntRandom.h"
+#include "visitedSet.h"
+
+struct LockstepResult
+{
+    long rounds = 0;
+    long moves = 0;
+    long contested = 0;         // Claims lost to a lower-indexed adventurer landing on the same cell
+    long spawned = 0;
+    long adventurers = 0;       // Initial plus spawned
+    long peakAdventurers = 0;   // Most adventurers alive in one round
+
+    int collected = 0;
+    int highestScore = 0;
+    int winnerId = -1;
+
+    long visitedLookups = 0;
+    long visitedProbes = 0;
+    long visitedBytes = 0;      // Summed over all adventurers
+    long peakVisitedBytes = 0;
+};
+
+class LockstepHunt
+{
+public:
+    LockstepHunt(std::vector<std::vector<Cell>>& huntGrid, int N, uint64_t seed, VisitedKind kind)
+        : grid(huntGrid), n(N), runSeed(seed), visitedKind(kind) {}
+
+    // Running T adventurers (streams 0..T-1) until they all retire or no treasure is left.
+    LockstepResult run(int T, int remainingTreasures)
+    {
+        result = LockstepResult();
+
+        for (int i = 0; i < T; i++)
+            add(i, (uint64_t)i);
+
+        while (count() > 0 && remainingTreasures > 0)
+        {
+            const int size = count();
+
+            result.rounds++;
+            result.peakAdventurers = std::max(result.peakAdventurers, (long)size);
+
+            propose(size);
+
+            int alive = move(size);
+
+            remainingTreasures -= resolve(size);
+
+            // Dropping retired adventurers once they are half of the arrays (spawns are already appended)
+            if (2 * alive <= size)
+                compact();
+        }
+
+        for (int a = 0; a < count(); a++)
+            retire(a);
+
+        return result;
+    }
+
+private:
+    static constexpr uint64_t NO_CLAIM = ~(uint64_t)0;
+    static constexpr uint32_t NO_WINNER = ~(uint32_t)0;
+
+    std::vector<std::vector<Cell>>& grid;
+    int n;
+    uint64_t runSeed;
+    VisitedKind visitedKind;
+
+    // One entry per adventurer
+    std::vector<int> x, y, score, bestScore, moves, id;
+    std::vector<uint64_t> stream, counter;
+    std::vector<uint8_t> active;
+    std::vector<VisitedSet> visited;
+
+    // Per round: proposed cell, whether it is on the grid, and the claim (cell index) with its table slot
+    std::vector<int> targetX, targetY;
+    std::vector<uint8_t> inside;
+    std::vector<uint64_t> claim;
+    std::vector<uint32_t> claimSlot;
+
+    // Claim table: cell index -> lowest adventurer index that landed on it this round
+    std::unique_ptr<std::atomic<uint64_t>[]> tableKeys;
+    std::unique_ptr<std::atomic<uint32_t>[]> tableWinners;
+    size_t tableSize = 0;
+
+    LockstepResult result;
+
+    int count() const { return (int)x.size(); }
+
+    uint64_t draw(int a) { return counterRandom(runSeed, stream[a], counter[a]++); }
+
+    // Appending an adventurer; its start position comes from its own stream, as in the task engine.
+    void add(int adventurerId, uint64_t streamKey)
+    {
+        RandomStream rng(runSeed, streamKey);
+
+        int startX = rng.below(n), startY = rng.below(n);
+
+        x.push_back(startX);
+        y.push_back(startY);
+        score.push_back(0);
+        bestScore.push_back(0);
+        moves.push_back(0);
+        id.push_back(adventurerId);
+        stream.push_back(streamKey);
+        counter.push_back(2);
+        active.push_back(1);
+        visited.emplace_back();
+        visited.back().reset(visitedKind, n);
+        visited.back().insert(startX, startY);
+
+        result.adventurers++;
+    }
+
+    // Folding adventurer a into the totals (called once per adventurer, when it leaves the arrays).
+    void retire(int a)
+    {
+        long bytes = (long)visited[a].bytesUsed();
+
+        result.moves += moves[a];
+        result.visitedLookups += visited[a].getLookups();
+        result.visitedProbes += visited[a].getProbes();
+        result.visitedBytes += bytes;
+        result.peakVisitedBytes = std::max(result.peakVisitedBytes, bytes);
+
+        // Highest score reached at any point; ties go to the adventurer retired first
+        if (bestScore[a] > result.highestScore)
+        {
+            result.highestScore = bestScore[a];
+            result.winnerId = id[a];
+        }
+    }
+
+    void compact()
+    {
+        int kept = 0;
+
+        for (int a = 0; a < count(); a++)
+        {
+            if (!active[a])
+            {
+                retire(a);
+
+                continue;
+            }
+
+            if (kept != a)
+            {
+                x[kept] = x[a];
+                y[kept] = y[a];
+                score[kept] = score[a];
+                bestScore[kept] = bestScore[a];
+                moves[kept] = moves[a];
+                id[kept] = id[a];
+                stream[kept] = stream[a];
+                counter[kept] = counter[a];
+                active[kept] = 1;
+                visited[kept] = std::move(visited[a]);
+            }
+
+            kept++;
+        }
+
+        x.resize(kept);
+        y.resize(kept);
+        score.resize(kept);
+        bestScore.resize(kept);
+        moves.resize(kept);
+        id.resize(kept);
+        stream.resize(kept);
+        counter.resize(kept);
+        active.resize(kept);
+        visited.resize(kept);
+    }
+
+    // Pass 1: one random direction per adventurer and the bounds check, without branches.
+    void propose(int size)
+    {
+        targetX.resize(size);
+        targetY.resize(size);
+        inside.resize(size);
+
+        int* __restrict tx = targetX.data();
+        int* __restrict ty = targetY.data();
+        uint8_t* __restrict in = inside.data();
+        const int* px = x.data();
+        const int* py = y.data();
+        const uint64_t* keys = stream.data();
+        uint64_t* counters = counter.data();
+        const uint64_t seed = runSeed;
+        const unsigned limit = (unsigned)n;
+
+        #pragma omp parallel for simd schedule(static)
+        for (int a = 0; a < size; a++)
+        {
+            // Directions 0-up, 1-down, 2-left, 3-right, as in the task engine
+            int direction = boundedRandom(counterRandom(seed, keys[a], counters[a]), 4);
+            int nx = px[a] + (direction == 1) - (direction == 0);
+            int ny = py[a] + (direction == 3) - (direction == 2);
+
+            counters[a]++;
+            tx[a] = nx;
+            ty[a] = ny;
+            in[a] = ((unsigned)nx < limit) & ((unsigned)ny < limit);
+        }
+    }
+
+    // Making sure the claim table has room for size claims at most half full, and is empty.
+    void prepareTable(int size)
+    {
+        if (tableSize >= 2 * (size_t)size && tableSize > 0)
+            return;
+
+        tableSize = 16;
+
+        while (tableSize < 2 * (size_t)size)
+            tableSize *= 2;
+
+        tableKeys.reset(new std::atomic<uint64_t>[tableSize]);
+        tableWinners.reset(new std::atomic<uint32_t>[tableSize]);
+
+        #pragma omp parallel for schedule(static)
+        for (size_t s = 0; s < tableSize; s++)
+        {
+            tableKeys[s].store(NO_CLAIM, std::memory_order_relaxed);
+            tableWinners[s].store(NO_WINNER, std::memory_order_relaxed);
+        }
+    }
+
+    // Registering adventurer a's claim on cell key; returns the table slot.
+    uint32_t addClaim(uint64_t key, uint32_t a)
+    {
+        const size_t mask = tableSize - 1;
+        size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+
+        for (;;)
+        {
+            uint64_t current = tableKeys[slot].load(std::memory_order_relaxed);
+
+            if (current == NO_CLAIM && tableKeys[slot].compare_exchange_strong(current, key, std::memory_order_relaxed))
+                current = key;
+
+            if (current == key)
+                break;
+
+            slot = (slot + 1) & mask;
+        }
+
+        uint32_t winner = tableWinners[slot].load(std::memory_order_relaxed);
+
+        while (a < winner && !tableWinners[slot].compare_exchange_weak(winner, a, std::memory_order_relaxed))
+            ;
+
+        return (uint32_t)slot;
+    }
+
+    // Pass 2: taking valid moves and applying the cells that need no claim. Returns the adventurers still active.
+    int move(int size)
+    {
+        claim.assign(size, NO_CLAIM);
+        claimSlot.resize(size);
+
+        prepareTable(size);
+
+        int alive = 0;
+
+        #pragma omp parallel for schedule(static) reduction(+:alive)
+        for (int a = 0; a < size; a++)
+        {
+            if (!active[a])
+                continue;
+
+            int nx = targetX[a], ny = targetY[a];
+
+            if (!inside[a] || visited[a].contains(nx, ny))
+            {
+                // A failed attempt is the only time the adventurer can be boxed in by its own path
+                if (!hasUnvisitedNeighbor(visited[a], x[a], y[a], n))
+                    active[a] = 0;
+                else
+                    alive++;
+
+                continue;
+            }
+
+            x[a] = nx;
+            y[a] = ny;
+            visited[a].insert(nx, ny);
+            moves[a]++;
+
+            Cell &cell = grid[nx][ny];
+
+            switch (cell.type.load(std::memory_order_relaxed))
+            {
+                case TRAP:
+                    score[a] += cell.value; // Penalty (value is negative)
+
+                    break;
+                case DEADLY_TRAP:
+                    active[a] = 0;
+
+                    break;
+                case TREASURE:
+                case RESURRECTION:
+                    claim[a] = (uint64_t)nx * n + ny;
+                    claimSlot[a] = addClaim(claim[a], (uint32_t)a);
+
+                    break;
+                default:
+                    break;
+            }
+
+            alive += active[a];
+        }
+
+        return alive;
+    }
+
+    // Pass 3: handing each claimed cell to its lowest-indexed claimant. Returns the treasures collected.
+    int resolve(int size)
+    {
+        const int threads = omp_get_max_threads();
+
+        std::vector<std::vector<int>> parents(threads);  // Stone winners, per thread
+
+        int collected = 0;
+        long contested = 0;
+
+        #pragma omp parallel reduction(+:collected, contested)
+        {
+            std::vector<int>& mine = parents[omp_get_thread_num()];
+
+            // Static chunks are contiguous and ascending by thread, so the parent lists concatenate in index order
+            #pragma omp for schedule(static)
+            for (int a = 0; a < size; a++)
+            {
+                if (claim[a] == NO_CLAIM)
+                    continue;
+
+                if (tableWinners[claimSlot[a]].load(std::memory_order_relaxed) != (uint32_t)a)
+                {
+                    contested++;
+
+                    continue;
+                }
+
+                Cell &cell = grid[x[a]][y[a]];
+
+                if (cell.type.load(std::memory_order_relaxed) == TREASURE)
+                {
+                    score[a] += cell.value;
+                    collected++;
+                }
+                else
+                    mine.push_back(a);
+
+                cell.type.store(EMPTY, std::memory_order_relaxed);
+            }
+
+            // Clearing the used table slots for the next round (after every winner has been read)
+            #pragma omp for schedule(static)
+            for (int a = 0; a < size; a++)
+            {
+                if (claim[a] != NO_CLAIM)
+                {
+                    tableKeys[claimSlot[a]].store(NO_CLAIM, std::memory_order_relaxed);
+                    tableWinners[claimSlot[a]].store(NO_WINNER, std::memory_order_relaxed);
+                }
+            }
+
+            #pragma omp for simd schedule(static)
+            for (int a = 0; a < size; a++)
+                bestScore[a] = std::max(bestScore[a], score[a]);
+        }
+
+        result.collected += collected;
+        result.contested += contested;
+
+        // Spawning in index order; a child's id and stream come from its parent's stream
+        for (const std::vector<int>& list : parents)
+        {
+            for (int parent : list)
+            {
+                int childId = boundedRandom(draw(parent), 1000) + 1000;
+                uint64_t childStream = draw(parent) & ~GRID_STREAMS;
+
+                add(childId, childStream);
+                result.spawned++;
+            }
+        }
+
+        return collected;
+    }
+};
@@ -10,30 +10,51 @@
  *              and traps. Each thread accumulates scores dynamically while
  *              navigating the grid. The simulation incorporates barriers,
  *              synchronization, and dynamic thread management to enhance
- *              realism and efficiency.
+ *              realism and efficiency. Cell state is atomic: treasures and
+ *              resurrection stones are claimed with compare-and-swap, so
+ *              exactly one adventurer wins a contested cell and moves do
+ *              not serialize on a global lock. Each adventurer's visited
+ *              cells are kept in a bitmap or a sparse block table, chosen
+ *              from the grid size (visitedSet.h). Random numbers come from
+ *              counter-based streams (huntRandom.h) keyed by a run seed
+ *              (--seed), so a seed reproduces the grid and every
+ *              adventurer's choices. Events go through per-thread ring
+ *              buffers to a background writer (eventLog.h). A second
+ *              engine (lockstepHunt.h) keeps adventurers as arrays and
+ *              advances them in rounds, for millions of adventurers, and a
+ *              third (shardedHunt.h) gives each thread a band of the grid
+ *              and hands adventurers between bands through queues. In the
+ *              task engine, adventurer states are recycled and the number
+ *              of live adventurers can be capped (--max-live), with
+ *              spawns beyond the cap queued (adventurerPool.h).
+ *              Running adventurers meet at checkpoints through an epoch
+ *              barrier they join and leave as they live and die
+ *              (checkpointBarrier.h).
  ********************************************************************/
 
 #include <iostream>
 #include <unistd.h>
 #include <vector>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <omp.h>
 #include <atomic>
-#include <set>
+#include <string>
+#include <algorithm>
+#include <memory>
 
-using namespace std;
-
-// Enumeration for cell types
-enum CellType { EMPTY, TREASURE, TRAP, RESURRECTION, DEADLY_TRAP };
-
-// Structure for a grid cell
-struct Cell 
-{
-    CellType type;
+#include "../common/benchmarkHarness.h"
+#include "adventurerPool.h"
+#include "checkpointBarrier.h"
+#include "eventLog.h"
+#include "huntGrid.h"
+#include "huntRandom.h"
+#include "lockstepHunt.h"
+#include "shardedHunt.h"
+#include "visitedSet.h"
 
-    int value; // For treasure: positive score; for trap: negative penalty; others: 0.
-};
+using namespace std;
 
 // Structure for positions in the grid
 struct Position 
@@ -52,28 +73,68 @@ struct Adventurer
 
     Position pos;
 
-    // Keep track of visited cells to avoid revisiting: stored as (x,y) pairs.
-    set<pair<int,int>> visited;
+    // Keep track of visited cells to avoid revisiting (dense bitmap or sparse blocks, see visitedSet.h).
+    VisitedSet visited;
+
+    // Private random stream for the start position, directions and spawned adventurers' streams.
+    RandomStream rng;
 };
 
 // Global variables to track highest score and remaining treasures
 atomic<int> globalHighestScore(0);
 atomic<int> winnerId(-1);
 atomic<int> remainingTreasures(0);
+atomic<int> collectedTreasures(0);
+atomic<long> totalMoves(0);
+
+int initialTreasures = 0;
+
+// Event log settings (--log-level, --log-sample, --log-ring, --trace), the log of the current run and the
+// statistics of the last one. The benchmark turns it off unless --log-level is given, so console I/O is not measured.
+EventLogOptions logOptions;
+
+unique_ptr<EventLog> eventLog;
+EventLogStats lastLogStats;
 
 const int DYNAMIC_THRESHOLD = 50;  // Threshold score for passing dynamic barrier
 
+// Checkpoint barrier of the current task-engine run and the epoch / wait statistics of the last one
+unique_ptr<CheckpointBarrier> checkpoint;
+CheckpointStats lastCheckpoint;
+
+// Visited-set layout (--visited; VISITED_AUTO picks one per grid size) and its statistics over a run
+VisitedKind visitedMode = VISITED_AUTO;
+VisitedKind visitedKind = VISITED_DENSE;
+
+atomic<long> visitedSets(0);
+atomic<long> visitedLookups(0);
+atomic<long> visitedProbes(0);
+atomic<long> visitedBytes(0);
+atomic<long> peakVisitedBytes(0);
+
+// Simulation engine (--engine): one task per adventurer, the lockstep struct-of-arrays engine or the
+// sharded engine, and the statistics of the last lockstep and sharded runs
+string engine = "tasks";
+
+LockstepResult lastLockstep;
+ShardedResult lastSharded;
+
+// Live-adventurer cap of the task engine (--max-live, 0: none), the lifecycle manager and state pool of
+// the current run, and the spawn / reuse statistics of the last one
+int maxLive = 0;
+
+unique_ptr<LifecycleManager> lifecycle;
+unique_ptr<StatePool<Adventurer>> adventurerPool;
+LifecycleStats lastLifecycle;
+
+// Run seed (--seed, or the start time); adventurer i starts on stream i (grid cells use GRID_STREAMS and up).
+uint64_t runSeed = 0;
+
 // Global grid and its dimension
 vector<vector<Cell>> grid;
 
 int gridSize;
 
-// Utility: Check if (x, y) is within grid bounds.
-bool inBounds(int x, int y, int N) 
-{
-    return (x >= 0 && x < N && y >= 0 && y < N);
-}
-
 // Initializing grid with random placements
 // - TREASURE: 15% probability, value between 10 and 100.
 // - TRAP: 15% probability, penalty between -5 and -50.
@@ -83,27 +144,48 @@ bool inBounds(int x, int y, int N)
 void initializeGrid(int N) 
 {
     gridSize = N;
-    grid.resize(N, vector<Cell>(N, {EMPTY, 0}));
 
-    srand(time(NULL));
+    // Atomic cells cannot be copied, so every row is built in place (by the thread that fills it)
+    grid = vector<vector<Cell>>(N);
+
+    // Resetting the shared counters so the grid can be rebuilt for another run
+    remainingTreasures = 0;
+    collectedTreasures = 0;
+    totalMoves = 0;
+    globalHighestScore = 0;
+    winnerId = -1;
+
+    visitedSets = 0;
+    visitedLookups = 0;
+    visitedProbes = 0;
+    visitedBytes = 0;
+    peakVisitedBytes = 0;
+
+    int treasures = 0;
 
+    // Every cell draws from its own stream, so the grid depends only on the seed, not on the thread count
+    #pragma omp parallel for schedule(static) reduction(+:treasures)
     for (int i = 0; i < N; i++) 
     {
+        grid[i] = vector<Cell>(N);
+
         for (int j = 0; j < N; j++) 
         {
-            int r = rand() % 100;
+            RandomStream cellRandom(runSeed, GRID_STREAMS + (uint64_t)i * N + j);
+
+            int r = cellRandom.below(100);
         
             if (r < 15) 
             { // 15% chance for treasure
                 grid[i][j].type = TREASURE;
-                grid[i][j].value = 10 + rand() % 91; // Value between 10 and 100
+                grid[i][j].value = 10 + cellRandom.below(91); // Value between 10 and 100
             
-                remainingTreasures++;
+                treasures++;
             } 
             else if (r < 30) 
             { // 15% chance for trap
                 grid[i][j].type = TRAP;
-                grid[i][j].value = -(5 + rand() % 46); // Penalty between -5 and -50
+                grid[i][j].value = -(5 + cellRandom.below(46)); // Penalty between -5 and -50
             } 
             else if (r < 35) 
             { // 5% chance for resurrection stone
@@ -122,12 +204,82 @@ void initializeGrid(int N)
             }
         }
     }
+
+    remainingTreasures = treasures;
+    initialTreasures = treasures;
+}
+
+// Claiming a consumable cell: true for exactly one caller per cell.
+bool claimCell(Cell &cell, CellType type)
+{
+    CellType expected = type;
+
+    return cell.type.compare_exchange_strong(expected, EMPTY, memory_order_acq_rel, memory_order_relaxed);
+}
+
+// Counting the treasures still on the grid (for verifying remainingTreasures after a run).
+int countTreasureCells(int N)
+{
+    int count = 0;
+
+    #pragma omp parallel for reduction(+:count)
+    for (int i = 0; i < N; i++)
+    {
+        for (int j = 0; j < N; j++)
+            count += grid[i][j].type.load(memory_order_relaxed) == TREASURE;
+    }
+
+    return count;
+}
+
+void adventurerSimulation(int init_id, uint64_t streamKey, int N);
+
+// Task body: running the adventurer the task was created for, then pending spawns while there are
+// any, so a capped run reuses its tasks instead of creating one per spawn.
+void runAdventurers(SpawnRequest request, int N)
+{
+    lifecycle->taskStarted();
+
+    do
+    {
+        lifecycle->adventurerStarted();
+        adventurerSimulation(request.id, request.stream, N);
+    }
+    while (lifecycle->finishOrNext(request));
 }
 
-// The simulation function for an adventurer
-void adventurerSimulation(int init_id, int N) 
+// Starting an adventurer as a new task if a live slot is free, otherwise queueing it for a finishing one.
+// A spawning adventurer (member) is out of the checkpoint barrier while the task is created: the runtime
+// may run the task at once, and the child must not wait on a parent suspended beneath it.
+void spawnAdventurer(int id, uint64_t stream, int N, CheckpointBarrier::Member* member = NULL)
 {
-    Adventurer adv;
+    SpawnRequest request = {id, stream};
+
+    if (!lifecycle->tryReserve() && !lifecycle->defer(request))
+        return;
+
+    lifecycle->taskCreated();
+
+    if (member)
+        checkpoint->leave(*member);
+
+    #pragma omp task firstprivate(request, N)
+
+    runAdventurers(request, N);
+
+    if (member)
+        checkpoint->join(*member);
+}
+
+// The simulation function for an adventurer drawing its random numbers from stream streamKey
+void adventurerSimulation(int init_id, uint64_t streamKey, int N) 
+{
+    // A recycled state: its visited set keeps the memory of an earlier walk
+    unique_ptr<Adventurer> state = adventurerPool->acquire();
+    Adventurer& adv = *state;
+
+    adv.visited.reset(visitedKind, N);
+    adv.rng = RandomStream(runSeed, streamKey);
 
     adv.id = init_id;
     adv.score = 0;
@@ -135,18 +287,28 @@ void adventurerSimulation(int init_id, int N)
     adv.active = true;
 
     // Random starting position
-    adv.pos.x = rand() % N;
-    adv.pos.y = rand() % N;
-    adv.visited.insert({adv.pos.x, adv.pos.y});
+    adv.pos.x = adv.rng.below(N);
+    adv.pos.y = adv.rng.below(N);
+    adv.visited.insert(adv.pos.x, adv.pos.y);
+
+    // Taking part in the checkpoints from now until the adventurer stops
+    CheckpointBarrier::Member member;
+
+    checkpoint->join(member);
     
     while (adv.active) 
     {
         // End simulation if all treasures are collected
         if (remainingTreasures <= 0)
             break;
+
+        // An adventurer boxed in by its own path can never move again; retiring it
+        // instead of spinning keeps the run from hanging once everyone is stuck.
+        if (!hasUnvisitedNeighbor(adv.visited, adv.pos.x, adv.pos.y, N))
+            break;
         
         // Randomly choose a direction: 0-up, 1-down, 2-left, 3-right
-        int direction = rand() % 4;
+        int direction = adv.rng.below(4);
         int newX = adv.pos.x, newY = adv.pos.y;
     
         if (direction == 0) newX--;       // Up
@@ -156,99 +318,505 @@ void adventurerSimulation(int init_id, int N)
         
         // Validating move: within bounds and not previously visited
         if (!inBounds(newX, newY, N)) continue;
-        if (adv.visited.find({newX, newY}) != adv.visited.end()) continue;
+        if (adv.visited.contains(newX, newY)) continue;
         
         // Updating position and mark as visited
         adv.pos.x = newX;
         adv.pos.y = newY;
-        adv.visited.insert({newX, newY});
+        adv.visited.insert(newX, newY);
         adv.moves++;
         
-        // Processing cell in a critical section to safely update shared grid state.
-        #pragma omp critical
+        // Processing the cell without a global lock: traps and deadly traps are read-only, and a
+        // treasure or stone counts only for the adventurer whose claim succeeds (a loser finds it EMPTY).
+        Cell &cell = grid[newX][newY];
+
+        switch(cell.type.load(memory_order_acquire)) 
         {
-            Cell &cell = grid[newX][newY];
-            
-            switch(cell.type) 
-            {
-                case TREASURE:
-                    adv.score += cell.value;
-            
-                    cell.type = EMPTY;  // Treasure collected
-            
-                    remainingTreasures--;
-            
-                    cout << "-> Adventurer " << adv.id << " collected treasure at (" 
-                         << newX << "," << newY << ") for +" << cell.value 
-                         << " points. New score: " << adv.score << endl;
-            
-                         break;
-                case TRAP:
-                    adv.score += cell.value; // Penalty (value is negative)
-            
-                    cout << "-> Adventurer " << adv.id << " hit a trap at (" 
-                         << newX << "," << newY << ") for " << cell.value 
-                         << " points. New score: " << adv.score << endl;
-            
-                         break;
-                case RESURRECTION:
-                    cout << "-> Adventurer " << adv.id << " found a Resurrection Stone at (" 
-                         << newX << "," << newY << "). Spawning new adventurer." << endl;
-                    
-                         // Spawning a new adventurer task with a new ID.
-                    #pragma omp task firstprivate(N)
-                    
-                    adventurerSimulation(rand() % 1000 + 1000, N);
-                    
-                    cell.type = EMPTY;
-                    
+            case TREASURE:
+                if (!claimCell(cell, TREASURE))
                     break;
-                case DEADLY_TRAP:
-                    cout << "-> Adventurer " << adv.id << " encountered a Deadly Trap at (" 
-                         << newX << "," << newY << "). Terminating." << endl;
-                    
-                         adv.active = false;
-                    
-                         break;
-                default:
-                    // Empty cell: no effect.
+
+                adv.score += cell.value;
+
+                remainingTreasures--;
+                collectedTreasures++;
+
+                if (eventLog)
+                    eventLog->record(EVENT_TREASURE, adv.id, newX, newY, cell.value, adv.score);
+
+                break;
+            case TRAP:
+                adv.score += cell.value; // Penalty (value is negative)
+
+                if (eventLog)
+                    eventLog->record(EVENT_TRAP, adv.id, newX, newY, cell.value, adv.score);
+
+                break;
+            case RESURRECTION:
+                if (!claimCell(cell, RESURRECTION))
                     break;
-            }
-        }  // End critical section
 
-        // Updating global highest score if current adventurer’s score exceeds it.
-        #pragma omp critical
+                if (eventLog)
+                    eventLog->record(EVENT_RESURRECTION, adv.id, newX, newY, 0, adv.score);
+
+                // Spawning a new adventurer with a new ID, and a stream derived from this one's
+                {
+                    int childId = adv.rng.below(1000) + 1000;
+                    uint64_t childStream = adv.rng.next() & ~GRID_STREAMS;
+
+                    spawnAdventurer(childId, childStream, N, &member);
+                }
+
+                break;
+            case DEADLY_TRAP:
+                if (eventLog)
+                    eventLog->record(EVENT_DEADLY_TRAP, adv.id, newX, newY, 0, adv.score);
+
+                adv.active = false;
+
+                break;
+            default:
+                // Empty cell: no effect.
+                break;
+        }
+
+        // Updating global highest score if current adventurer’s score exceeds it. The unlocked check
+        // filters out almost every move; the lock keeps the score and winner id consistent.
+        if (adv.score > globalHighestScore.load(memory_order_relaxed))
         {
-            if (adv.score > globalHighestScore) 
+            #pragma omp critical(highestScore)
             {
-                globalHighestScore = adv.score;
-            
-                winnerId = adv.id;
+                if (adv.score > globalHighestScore) 
+                {
+                    globalHighestScore = adv.score;
+                
+                    winnerId = adv.id;
+                }
             }
         }
         
-        // Every 5 moves, synchronize adventurers at a checkpoint.
+        // Every 5 moves, synchronize adventurers at a checkpoint: a low scorer waits there until every
+        // running adventurer has arrived (the epoch ends), the others record their arrival and go on.
         if (adv.moves % 5 == 0) 
         {
-            #pragma omp taskwait
-            if (adv.score < DYNAMIC_THRESHOLD) 
-            {
-                cout << "-> Adventurer " << adv.id << " is waiting at checkpoint with low score (" 
-                     << adv.score << ")." << endl;
-                
-                // Waiting for other adventurers to reach the checkpoint.
-                #pragma omp taskwait
+            bool waiting = adv.score < DYNAMIC_THRESHOLD;
 
-            }
+            if (waiting && eventLog)
+                eventLog->record(EVENT_CHECKPOINT_WAIT, adv.id, adv.pos.x, adv.pos.y, 0, adv.score);
+
+            checkpoint->arrive(member, waiting);
         }
 
         // sleep(1);  // Simulating movement delay
     }
+
+    checkpoint->leave(member);
+
+    totalMoves += adv.moves;
+
+    // Adding this adventurer's visited-set footprint to the run statistics
+    long bytes = (long)adv.visited.bytesUsed();
+    long peak = peakVisitedBytes;
+
+    visitedSets++;
+    visitedLookups += adv.visited.getLookups();
+    visitedProbes += adv.visited.getProbes();
+    visitedBytes += bytes;
+
+    while (bytes > peak && !peakVisitedBytes.compare_exchange_weak(peak, bytes))
+        ;
+
+    adventurerPool->release(move(state));
+}
+
+// Expected number of cells an adventurer visits: a deadly trap (5% of cells) ends a walk after about
+// 20 moves on average, so 4x that covers most walks; never more than the grid.
+long expectedPathLength(int N)
+{
+    return min((long)N * N, 80L);
+}
+
+// Printing the visited-set layout used by the last run, its memory and lookup cost.
+void reportVisitedStats()
+{
+    long sets = max(1L, (long)visitedSets);
+    long lookups = max(1L, (long)visitedLookups);
+
+    cout << "-> Visited sets: " << visitedKindName(visitedKind) << ", " << visitedSets << " adventurers, "
+         << visitedBytes / sets << " bytes on average (peak " << peakVisitedBytes << "), "
+         << visitedLookups << " lookups at " << (double)visitedProbes / lookups << " probes each." << endl;
+}
+
+// Running one full hunt with T initial adventurers on the current grid.
+void runTreasureHunt(int N, int T)
+{
+    visitedKind = visitedMode != VISITED_AUTO ? visitedMode : chooseVisitedKind(N, expectedPathLength(N));
+
+    if (logOptions.level > 0)
+    {
+        eventLog.reset(new EventLog(logOptions, omp_get_max_threads()));
+
+        if (!eventLog->traceReady())
+            cerr << "Warning: cannot create trace file " << logOptions.tracePath << endl;
+    }
+
+    lifecycle.reset(new LifecycleManager(maxLive));
+    checkpoint.reset(new CheckpointBarrier(omp_get_max_threads()));
+    adventurerPool.reset(new StatePool<Adventurer>(omp_get_max_threads()));
+
+    // Starting the parallel region and spawn initial adventurer tasks.
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            for (int i = 0; i < T; i++) 
+                spawnAdventurer(i, (uint64_t)i, N);
+        }
+    }
+
+    lastCheckpoint = checkpoint->getStats();
+    checkpoint.reset();
+
+    lastLifecycle = LifecycleStats();
+    lifecycle->addStats(lastLifecycle);
+    adventurerPool->addStats(lastLifecycle);
+    lifecycle.reset();
+    adventurerPool.reset();
+
+    // Writing out what is still buffered before the results are printed
+    if (eventLog)
+    {
+        eventLog->close();
+        lastLogStats = eventLog->getStats();
+        eventLog.reset();
+    }
 }
 
-int main() 
+// Printing how many events the last run logged, sampled out and dropped.
+void reportEventLog()
+{
+    if (logOptions.level <= 0)
+        return;
+
+    cout << "-> Event log: " << lastLogStats.written << " events written in " << lastLogStats.batches << " batches, "
+         << lastLogStats.sampledOut << " sampled out, " << lastLogStats.dropped << " dropped (full buffers)." << endl;
+}
+
+// Printing the live-adventurer peak, deferred spawns, task queue depth and state reuse of the last task-engine run.
+void reportLifecycle()
+{
+    if (lastLifecycle.started == 0)
+        return;
+
+    double reuse = lastLifecycle.acquired ? 100.0 * lastLifecycle.reused / lastLifecycle.acquired : 0.0;
+
+    cout << "-> Adventurers: " << lastLifecycle.started << " run, peak " << lastLifecycle.peakLive << " live";
+
+    if (maxLive > 0)
+        cout << " (cap " << maxLive << ")";
+
+    cout << ", " << lastLifecycle.deferred << " spawns deferred (peak queue " << lastLifecycle.peakPending << "), peak "
+         << lastLifecycle.peakQueuedTasks << " tasks waiting to start, " << reuse << "% states reused." << endl;
+}
+
+// Visited-set layout for the batch engines (lockstep, sharded): every adventurer is alive at once there,
+// so dense bitmaps are only kept while T of them fit in 256 MiB.
+VisitedKind batchVisitedKind(int N, int T)
+{
+    if (visitedMode != VISITED_AUTO)
+        return visitedMode;
+
+    VisitedKind kind = chooseVisitedKind(N, expectedPathLength(N));
+
+    if (kind == VISITED_DENSE && denseVisitedBytes(N) * (size_t)T > ((size_t)256 << 20))
+        kind = VISITED_SPARSE;
+
+    return kind;
+}
+
+// Printing the epochs, arrivals and checkpoint wait times of the last task-engine run.
+void reportCheckpoints()
+{
+    if (lastCheckpoint.arrivals == 0)
+        return;
+
+    double perEpoch = lastCheckpoint.epochs ? 1000.0 * lastCheckpoint.waitSeconds / lastCheckpoint.epochs : 0.0;
+    double perWait = lastCheckpoint.waits ? 1000.0 * lastCheckpoint.waitSeconds / lastCheckpoint.waits : 0.0;
+
+    cout << "-> Checkpoints: " << lastCheckpoint.epochs << " epochs, " << lastCheckpoint.arrivals << " arrivals, "
+         << lastCheckpoint.waits << " waits; " << perEpoch << " ms waited per epoch, " << perWait << " ms per wait (longest "
+         << 1000.0 * lastCheckpoint.maxWaitSeconds << " ms)." << endl;
+}
+
+// Running one full hunt with T initial adventurers on the current grid with the lockstep engine.
+void runLockstepHunt(int N, int T)
+{
+    visitedKind = batchVisitedKind(N, T);
+
+    LockstepHunt hunt(grid, N, runSeed, visitedKind);
+
+    lastLockstep = hunt.run(T, remainingTreasures);
+
+    remainingTreasures -= lastLockstep.collected;
+    collectedTreasures += lastLockstep.collected;
+    totalMoves += lastLockstep.moves;
+    globalHighestScore = lastLockstep.highestScore;
+    winnerId = lastLockstep.winnerId;
+
+    visitedSets += lastLockstep.adventurers;
+    visitedLookups += lastLockstep.visitedLookups;
+    visitedProbes += lastLockstep.visitedProbes;
+    visitedBytes += lastLockstep.visitedBytes;
+    peakVisitedBytes = lastLockstep.peakVisitedBytes;
+}
+
+// Running one full hunt with T initial adventurers on the current grid with the sharded engine.
+void runShardedHunt(int N, int T)
+{
+    visitedKind = batchVisitedKind(N, T);
+
+    ShardedHunt hunt(grid, N, runSeed, visitedKind);
+
+    lastSharded = hunt.run(T, remainingTreasures);
+
+    remainingTreasures -= lastSharded.collected;
+    collectedTreasures += lastSharded.collected;
+    totalMoves += lastSharded.moves;
+    globalHighestScore = lastSharded.highestScore;
+    winnerId = lastSharded.winnerId;
+
+    visitedSets += lastSharded.adventurers;
+    visitedLookups += lastSharded.visitedLookups;
+    visitedProbes += lastSharded.visitedProbes;
+    visitedBytes += lastSharded.visitedBytes;
+    peakVisitedBytes = lastSharded.peakVisitedBytes;
+}
+
+// Running the hunt with the selected engine.
+void runHunt(int N, int T)
+{
+    if (engine == "lockstep")
+        runLockstepHunt(N, T);
+    else if (engine == "sharded")
+        runShardedHunt(N, T);
+    else
+        runTreasureHunt(N, T);
+}
+
+// Printing the rounds, conflicts and population of the last lockstep run.
+void reportLockstep()
+{
+    if (lastLockstep.rounds == 0)
+        return;
+
+    cout << "-> Lockstep: " << lastLockstep.rounds << " rounds, " << lastLockstep.adventurers << " adventurers ("
+         << lastLockstep.spawned << " spawned, peak " << lastLockstep.peakAdventurers << " at once), "
+         << lastLockstep.contested << " contested claims lost." << endl;
+}
+
+// Printing the shard count, migration rates and rebalancing of the last sharded run.
+void reportShards()
+{
+    if (lastSharded.epochs == 0)
+        return;
+
+    double perMove = lastSharded.moves ? (double)lastSharded.migrations / lastSharded.moves : 0.0;
+    double perEpoch = (double)lastSharded.migrations / lastSharded.epochs;
+
+    cout << "-> Shards: " << lastSharded.shards << " bands, " << lastSharded.epochs << " epochs, " << lastSharded.migrations
+         << " migrations (" << 100.0 * perMove << "% of moves, " << perEpoch << " per epoch), " << lastSharded.forwards
+         << " forwarded, " << lastSharded.backlogged << " delayed by full queues; " << lastSharded.rebalances << " rebalances moved "
+         << lastSharded.rebalanceMoves << " adventurers (peak load " << lastSharded.peakImbalance << "x average)." << endl;
+}
+
+// Whether two lockstep runs took the same course (every field that depends on the run, not on its memory use).
+bool sameLockstepResult(const LockstepResult& a, const LockstepResult& b)
+{
+    return a.rounds == b.rounds && a.moves == b.moves && a.contested == b.contested && a.spawned == b.spawned
+        && a.adventurers == b.adventurers && a.peakAdventurers == b.peakAdventurers && a.collected == b.collected
+        && a.highestScore == b.highestScore && a.winnerId == b.winnerId;
+}
+
+// Registering the hunt with the benchmark harness. Task, sharded and serial runs depend on thread timing,
+// so their verification checks that every treasure is accounted for exactly once (and that the counter
+// matches the grid). The lockstep engine is deterministic for a seed, so it is also compared with a
+// 1-thread lockstep run of the same seed, computed on first use.
+void registerTreasureHuntBenchmarks(BenchmarkHarness& harness, int N, int T)
+{
+    BenchmarkCase c;
+
+    c.benchmark = "treasureHunt";
+    c.size = to_string(N) + "x" + to_string(N) + "/" + to_string(T);
+    c.unit = "moves";
+    c.setup = [=]() { initializeGrid(N); };
+    c.run = [=]() { runTreasureHunt(N, T); return (double)totalMoves; };
+    c.verify = [=]() {
+        return collectedTreasures + remainingTreasures == initialTreasures && countTreasureCells(N) == remainingTreasures;
+    };
+
+    c.variant = "serial";
+    c.parallel = false;
+    harness.add(c);
+
+    c.variant = "tasks";
+    c.parallel = true;
+    harness.add(c);
+
+    auto serialLockstep = make_shared<LockstepResult>();
+    auto serialReady = make_shared<bool>(false);
+
+    c.variant = "lockstep";
+    c.run = [=]() { runLockstepHunt(N, T); return (double)totalMoves; };
+    c.verify = [=]() {
+        if (collectedTreasures + remainingTreasures != initialTreasures || countTreasureCells(N) != remainingTreasures)
+            return false;
+
+        LockstepResult measured = lastLockstep;
+
+        if (!*serialReady)
+        {
+            int threads = omp_get_max_threads();
+
+            omp_set_num_threads(1);
+            initializeGrid(N);
+            runLockstepHunt(N, T);
+            omp_set_num_threads(threads);
+
+            *serialLockstep = lastLockstep;
+            *serialReady = true;
+            lastLockstep = measured;
+        }
+
+        return sameLockstepResult(measured, *serialLockstep);
+    };
+    harness.add(c);
+
+    c.verify = [=]() {
+        return collectedTreasures + remainingTreasures == initialTreasures && countTreasureCells(N) == remainingTreasures;
+    };
+
+    c.variant = "sharded";
+    c.run = [=]() { runShardedHunt(N, T); return (double)totalMoves; };
+    harness.add(c);
+}
+
+int main(int argc, char* argv[]) 
 {
     int N, T;
+
+    // --bench --grid N --adventurers T1,T2,... [--bench-* options]: running through the shared benchmark harness
+    //   (every variant, including the lockstep and sharded engines, for each adventurer count)
+    // --engine tasks|lockstep|sharded: engine of the interactive run (default: tasks, one OpenMP task per adventurer)
+    // --visited auto|dense|sparse: layout of the per-adventurer visited sets (default: chosen from N)
+    // --max-live N: most adventurers alive at once in the task engine (default 0: no cap); further spawns wait in a queue
+    // --seed S: run seed (default: the current time); the grid and each adventurer's choices depend only on it
+    // --log-level 0..3 [--log-sample N] [--log-ring EVENTS] [--trace FILE]: event verbosity (0 off, 1 deaths
+    //   and spawns, 2 + treasures, 3 + traps and checkpoint waits; default 3, 0 when benchmarking), keeping 1
+    //   of every N events, per-thread buffer size, and a binary trace of the logged events
+    runSeed = (uint64_t)time(NULL);
+
+    BenchmarkConfig config;
+    bool bench = false, logLevelGiven = false;
+    vector<int> adventurerCounts = {8};
+
+    N = 100;
+
+    if (argc > 1)
+    {
+        bool valid = true;
+
+        for (int a = 1; a < argc && valid; a++)
+        {
+            string arg = argv[a];
+
+            if (arg == "--bench")
+                bench = true;
+            else if (arg == "--grid" && a + 1 < argc)
+                N = atoi(argv[++a]);
+            else if (arg == "--adventurers" && a + 1 < argc)
+            {
+                adventurerCounts.clear();
+
+                for (char* tok = strtok(argv[++a], ","); tok != NULL; tok = strtok(NULL, ","))
+                    adventurerCounts.push_back(atoi(tok));
+
+                valid = !adventurerCounts.empty();
+            }
+            else if (arg == "--engine" && a + 1 < argc)
+            {
+                engine = argv[++a];
+                valid = engine == "tasks" || engine == "lockstep" || engine == "sharded";
+            }
+            else if (arg == "--visited" && a + 1 < argc)
+            {
+                string mode = argv[++a];
+
+                visitedMode = mode == "dense" ? VISITED_DENSE : mode == "sparse" ? VISITED_SPARSE : VISITED_AUTO;
+                valid = mode == "dense" || mode == "sparse" || mode == "auto";
+            }
+            else if (arg == "--max-live" && a + 1 < argc)
+            {
+                maxLive = atoi(argv[++a]);
+                valid = maxLive >= 0;
+            }
+            else if (arg == "--seed" && a + 1 < argc)
+                runSeed = strtoull(argv[++a], NULL, 0);
+            else if (arg == "--log-level" && a + 1 < argc)
+            {
+                logOptions.level = atoi(argv[++a]);
+                logLevelGiven = true;
+                valid = logOptions.level >= 0 && logOptions.level <= 3;
+            }
+            else if (arg == "--log-sample" && a + 1 < argc)
+            {
+                logOptions.sample = atoi(argv[++a]);
+                valid = logOptions.sample > 0;
+            }
+            else if (arg == "--log-ring" && a + 1 < argc)
+            {
+                logOptions.ringEvents = atoi(argv[++a]);
+                valid = logOptions.ringEvents > 0;
+            }
+            else if (arg == "--trace" && a + 1 < argc)
+                logOptions.tracePath = argv[++a];
+            else
+                valid = parseBenchmarkOption(a, argc, argv, config);
+        }
+
+        for (int count : adventurerCounts)
+            valid = valid && count > 0;
+
+        if (!valid || N <= 0)
+        {
+            cout << "Usage: " << argv[0] << " [--seed S] [--visited auto|dense|sparse] [--log-level L] [--log-sample N] [--log-ring EVENTS] [--trace FILE] [--engine tasks|lockstep|sharded] [--max-live N] [--bench [--grid N] [--adventurers T1,T2,...] " << benchmarkUsage() << "]" << endl;
+
+            return 1;
+        }
+    }
+
+    if (bench)
+    {
+        if (!logLevelGiven)
+            logOptions.level = 0;
+
+        BenchmarkHarness harness(config);
+
+        for (int count : adventurerCounts)
+            registerTreasureHuntBenchmarks(harness, N, count);
+
+        bool passed = harness.run();
+
+        harness.report();
+
+        reportVisitedStats();
+        reportEventLog();
+        reportLifecycle();
+        reportCheckpoints();
+        reportLockstep();
+        reportShards();
+
+        return passed ? 0 : 1;
+    }
     
     cout << "Please, input grid size (N): ";
     cin >> N;
@@ -260,25 +828,22 @@ int main()
     
     initializeGrid(N);
 
-    cout << "> Simulation:" << endl;
+    cout << "> Simulation (seed " << runSeed << "):" << endl;
     
-    // Starting the parallel region and spawn initial adventurer tasks.
-    #pragma omp parallel
-    {
-        #pragma omp single
-        {
-            for (int i = 0; i < T; i++) 
-            {
-                #pragma omp task firstprivate(N)
-            
-                adventurerSimulation(i, N);
-            }
-        }
-    }
+    runHunt(N, T);
     
     cout << "\n> Treasure hunt completed." << endl;
     cout << "-> Winner: Adventurer " << winnerId 
-         << " with score " << globalHighestScore << endl << endl;
+         << " with score " << globalHighestScore << endl;
+
+    reportVisitedStats();
+    reportEventLog();
+    reportLifecycle();
+    reportCheckpoints();
+    reportLockstep();
+    reportShards();
+
+    cout << endl;
     
     return 0;
-}
+}
\ No newline at end of file
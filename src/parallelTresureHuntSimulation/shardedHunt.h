@@ -0,0 +1,587 @@
+/********************************************************************
+ * File:        shardedHunt.h
+ *
+ * Description: Spatially sharded treasure hunt engine. The grid is cut
+ *              into horizontal bands (full-width rectangles of rows), one
+ *              per OpenMP thread. A thread steps only the adventurers in
+ *              its band and is the only one to read or change the band's
+ *              cells, so cell access needs no atomics or locks.
+ *
+ *              An adventurer stepping across a band boundary is handed to
+ *              the neighboring shard through a lock-free single-producer /
+ *              single-consumer queue (one per direction per boundary);
+ *              the receiving shard applies the cell it landed on. A full
+ *              queue never blocks: the adventurer waits in a local backlog
+ *              and is sent on the next step. Adventurers bound for a band
+ *              further away (spawn positions, rebalancing) are forwarded
+ *              one hop at a time.
+ *
+ *              Threads run independently for an epoch of a few steps,
+ *              then settle in-flight adventurers and check for the end of
+ *              the hunt. If one band holds much more than its share of
+ *              adventurers, the band boundaries are moved so each holds
+ *              about the same number, and adventurers outside their new
+ *              band migrate. The end of the hunt is only noticed at epoch
+ *              boundaries, and results depend on handoff timing, so unlike
+ *              the lockstep engine they vary with the thread count.
+ ********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <omp.h>
+
+#include "huntGrid.h"
+#include "huntRandom.h"
+#include "visitedSet.h"
+
+struct ShardedResult
+{
+    int shards = 0;
+    long epochs = 0;
+    long steps = 0;           // Per shard, summed over shards
+    long moves = 0;
+    long migrations = 0;      // Adventurers stepping into another shard's band
+    long forwards = 0;        // Extra hops through bands in between
+    long rebalances = 0;
+    long rebalanceMoves = 0;  // Adventurers that changed shard because their band moved
+    long backlogged = 0;      // Handoffs delayed by a full queue
+    long spawned = 0;
+    long adventurers = 0;     // Initial plus spawned
+    double peakImbalance = 0; // Largest (most loaded shard / average) seen at an epoch boundary with enough adventurers to rebalance
+
+    int collected = 0;
+    int highestScore = 0;
+    int winnerId = -1;
+
+    long visitedLookups = 0;
+    long visitedProbes = 0;
+    long visitedBytes = 0;    // Summed over all adventurers
+    long peakVisitedBytes = 0;
+};
+
+class ShardedHunt
+{
+public:
+    ShardedHunt(std::vector<std::vector<Cell>>& huntGrid, int N, uint64_t seed, VisitedKind kind, int epochSteps = 16)
+        : grid(huntGrid), n(N), runSeed(seed), visitedKind(kind), stepsPerEpoch(std::max(1, epochSteps)) {}
+
+    // Running T adventurers (streams 0..T-1) until they all retire or no treasure is left.
+    ShardedResult run(int T, int remainingTreasures)
+    {
+        result = ShardedResult();
+
+        #pragma omp parallel
+        {
+            #pragma omp single
+            setup(omp_get_num_threads());
+
+            const int t = omp_get_thread_num();
+
+            // Each shard creates the initial adventurers that start in its band (the start row is the stream's first value)
+            for (int i = 0; i < T; i++)
+            {
+                if (owns(t, RandomStream(runSeed, (uint64_t)i).below(n)))
+                    shards[t]->walkers.push_back(newWalker(i, (uint64_t)i));
+            }
+
+            for (;;)
+            {
+                for (int s = 0; s < stepsPerEpoch; s++)
+                    step(t);
+
+                settle(t);
+
+                Shard& shard = *shards[t];
+
+                shard.live = (long)shard.walkers.size();
+
+                for (int r = bounds[t]; r < bounds[t + 1]; r++)
+                    rowLoad[r] = 0;
+
+                for (const std::unique_ptr<Walker>& walker : shard.walkers)
+                    rowLoad[walker->x]++;
+
+                #pragma omp barrier
+
+                #pragma omp single
+                endEpoch(remainingTreasures);
+
+                if (stopping)
+                    break;
+
+                if (rebalanced)
+                {
+                    redistribute(t);
+                    settle(t);
+                }
+            }
+
+            Shard& shard = *shards[t];
+
+            for (std::unique_ptr<Walker>& walker : shard.walkers)
+                retire(shard, *walker);
+
+            shard.walkers.clear();
+        }
+
+        for (const std::unique_ptr<Shard>& shard : shards)
+            merge(*shard);
+
+        result.shards = (int)shards.size();
+
+        return result;
+    }
+
+private:
+    struct Walker
+    {
+        int id;
+        int x, y;
+        int score = 0, bestScore = 0;
+        int moves = 0;
+        bool arriving = false;  // Landed on a cell of the receiving band that is not applied yet
+
+        RandomStream rng;
+        VisitedSet visited;
+    };
+
+    // Lock-free single-producer / single-consumer handoff queue of adventurers.
+    class Handoff
+    {
+    public:
+        explicit Handoff(size_t capacity = 1024) : slots(capacity) {}
+
+        bool push(Walker* walker)
+        {
+            const uint64_t h = head.load(std::memory_order_relaxed);
+
+            if (h - tail.load(std::memory_order_acquire) == slots.size())
+                return false;
+
+            slots[h & (slots.size() - 1)] = walker;
+            head.store(h + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        Walker* pop()
+        {
+            const uint64_t t = tail.load(std::memory_order_relaxed);
+
+            if (t == head.load(std::memory_order_acquire))
+                return NULL;
+
+            Walker* walker = slots[t & (slots.size() - 1)];
+
+            tail.store(t + 1, std::memory_order_release);
+
+            return walker;
+        }
+
+        long size() const { return (long)(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire)); }
+
+    private:
+        std::vector<Walker*> slots;
+
+        alignas(64) std::atomic<uint64_t> head{0};  // Written by the producer
+        alignas(64) std::atomic<uint64_t> tail{0};  // Written by the consumer
+    };
+
+    // Everything a shard's thread touches while stepping; other threads only push into its inboxes.
+    struct alignas(64) Shard
+    {
+        std::vector<std::unique_ptr<Walker>> walkers;
+        std::vector<std::unique_ptr<Walker>> backlogUp, backlogDown;  // Waiting for room in a full queue
+
+        Handoff fromAbove, fromBelow;  // Inboxes, written by shard t-1 and t+1
+
+        long live = 0;     // Adventurers after the last settle (read by endEpoch)
+        long pending = 0;  // In flight after a settle round (read by every thread)
+
+        int collected = 0;
+        ShardedResult totals;  // Per-shard counters, merged after the run
+    };
+
+    std::vector<std::vector<Cell>>& grid;
+    int n;
+    uint64_t runSeed;
+    VisitedKind visitedKind;
+    int stepsPerEpoch;
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<int> bounds;   // Shard t owns rows [bounds[t], bounds[t + 1]); changed only between barriers
+    std::vector<long> rowLoad; // Adventurers per row at the last epoch boundary
+
+    static constexpr long MIN_REBALANCE = 16;
+
+    bool stopping = false;
+    bool rebalanced = false;
+
+    ShardedResult result;
+
+    void setup(int count)
+    {
+        shards.clear();
+
+        for (int t = 0; t < count; t++)
+            shards.emplace_back(new Shard());
+
+        // Equal bands to start with; rebalancing follows the adventurers from there
+        bounds.resize(count + 1);
+
+        for (int t = 0; t <= count; t++)
+            bounds[t] = (int)((long)n * t / count);
+
+        rowLoad.assign(n, 0);
+        stopping = rebalanced = false;
+    }
+
+    bool owns(int t, int row) const { return row >= bounds[t] && row < bounds[t + 1]; }
+
+    // A new adventurer on stream streamKey; its start position comes from its own stream, as in the other engines.
+    std::unique_ptr<Walker> newWalker(int adventurerId, uint64_t streamKey)
+    {
+        std::unique_ptr<Walker> walker(new Walker());
+
+        walker->id = adventurerId;
+        walker->rng = RandomStream(runSeed, streamKey);
+        walker->x = walker->rng.below(n);
+        walker->y = walker->rng.below(n);
+        walker->visited.reset(visitedKind, n);
+        walker->visited.insert(walker->x, walker->y);
+
+        return walker;
+    }
+
+    // Folding an adventurer that leaves the hunt into its shard's totals.
+    void retire(Shard& shard, const Walker& walker)
+    {
+        ShardedResult& totals = shard.totals;
+        long bytes = (long)walker.visited.bytesUsed();
+
+        totals.moves += walker.moves;
+        totals.adventurers++;
+        totals.visitedLookups += walker.visited.getLookups();
+        totals.visitedProbes += walker.visited.getProbes();
+        totals.visitedBytes += bytes;
+        totals.peakVisitedBytes = std::max(totals.peakVisitedBytes, bytes);
+
+        if (walker.bestScore > totals.highestScore)
+        {
+            totals.highestScore = walker.bestScore;
+            totals.winnerId = walker.id;
+        }
+    }
+
+    void merge(const Shard& shard)
+    {
+        const ShardedResult& totals = shard.totals;
+
+        result.steps += totals.steps;
+        result.moves += totals.moves;
+        result.migrations += totals.migrations;
+        result.forwards += totals.forwards;
+        result.rebalanceMoves += totals.rebalanceMoves;
+        result.backlogged += totals.backlogged;
+        result.spawned += totals.spawned;
+        result.adventurers += totals.adventurers;
+        result.collected += shard.collected;
+        result.visitedLookups += totals.visitedLookups;
+        result.visitedProbes += totals.visitedProbes;
+        result.visitedBytes += totals.visitedBytes;
+        result.peakVisitedBytes = std::max(result.peakVisitedBytes, totals.peakVisitedBytes);
+
+        if (totals.highestScore > result.highestScore)
+        {
+            result.highestScore = totals.highestScore;
+            result.winnerId = totals.winnerId;
+        }
+    }
+
+    // Handing an adventurer outside band t one hop towards its row (to the backlog if the queue is full).
+    void send(int t, std::unique_ptr<Walker> walker)
+    {
+        Shard& shard = *shards[t];
+        bool up = walker->x < bounds[t];
+
+        Handoff& inbox = up ? shards[t - 1]->fromBelow : shards[t + 1]->fromAbove;
+        std::vector<std::unique_ptr<Walker>>& backlog = up ? shard.backlogUp : shard.backlogDown;
+
+        // Keeping the queue in order: nothing overtakes a backlog
+        if (backlog.empty() && inbox.push(walker.get()))
+        {
+            walker.release();
+
+            return;
+        }
+
+        backlog.push_back(std::move(walker));
+        shard.totals.backlogged++;
+    }
+
+    void flush(std::vector<std::unique_ptr<Walker>>& backlog, Handoff& inbox)
+    {
+        size_t sent = 0;
+
+        while (sent < backlog.size() && inbox.push(backlog[sent].get()))
+            backlog[sent++].release();
+
+        backlog.erase(backlog.begin(), backlog.begin() + sent);
+    }
+
+    // Taking in the adventurers handed to shard t, and sending the backlogs on.
+    void receive(int t)
+    {
+        Shard& shard = *shards[t];
+        Handoff* inboxes[2] = {&shard.fromAbove, &shard.fromBelow};
+
+        for (Handoff* inbox : inboxes)
+        {
+            while (Walker* raw = inbox->pop())
+            {
+                std::unique_ptr<Walker> walker(raw);
+
+                if (!owns(t, walker->x))
+                {
+                    shard.totals.forwards++;
+                    send(t, std::move(walker));
+
+                    continue;
+                }
+
+                if (walker->arriving)
+                {
+                    walker->arriving = false;
+
+                    if (!applyCell(t, *walker))
+                    {
+                        retire(shard, *walker);
+
+                        continue;
+                    }
+                }
+
+                shard.walkers.push_back(std::move(walker));
+            }
+        }
+
+        if (t > 0)
+            flush(shard.backlogUp, shards[t - 1]->fromBelow);
+
+        if (t + 1 < (int)shards.size())
+            flush(shard.backlogDown, shards[t + 1]->fromAbove);
+    }
+
+    // Applying the cell walker stands on (in band t, so only this thread touches it). False if the walker dies.
+    bool applyCell(int t, Walker& walker)
+    {
+        Shard& shard = *shards[t];
+        Cell& cell = grid[walker.x][walker.y];
+        bool alive = true;
+
+        switch (cell.type.load(std::memory_order_relaxed))
+        {
+            case TREASURE:
+                walker.score += cell.value;
+                shard.collected++;
+                cell.type.store(EMPTY, std::memory_order_relaxed);
+
+                break;
+            case TRAP:
+                walker.score += cell.value; // Penalty (value is negative)
+
+                break;
+            case RESURRECTION:
+                cell.type.store(EMPTY, std::memory_order_relaxed);
+
+                // Spawning a new adventurer with an ID and stream derived from this one's
+                {
+                    int childId = walker.rng.below(1000) + 1000;
+                    uint64_t childStream = walker.rng.next() & ~GRID_STREAMS;
+
+                    std::unique_ptr<Walker> child = newWalker(childId, childStream);
+
+                    shard.totals.spawned++;
+
+                    if (owns(t, child->x))
+                        shard.walkers.push_back(std::move(child));
+                    else
+                        send(t, std::move(child));
+                }
+
+                break;
+            case DEADLY_TRAP:
+                alive = false;
+
+                break;
+            default:
+                break;
+        }
+
+        walker.bestScore = std::max(walker.bestScore, walker.score);
+
+        return alive;
+    }
+
+    // One move attempt for every adventurer in band t.
+    void step(int t)
+    {
+        Shard& shard = *shards[t];
+
+        receive(t);
+
+        shard.totals.steps++;
+
+        // Spawns append to walkers while this runs; they move from the next step
+        const size_t size = shard.walkers.size();
+
+        for (size_t w = 0; w < size; w++)
+        {
+            Walker& walker = *shard.walkers[w];
+
+            // Directions 0-up, 1-down, 2-left, 3-right, as in the other engines
+            int direction = walker.rng.below(4);
+            int nx = walker.x + (direction == 1) - (direction == 0);
+            int ny = walker.y + (direction == 3) - (direction == 2);
+
+            if (!inBounds(nx, ny, n) || walker.visited.contains(nx, ny))
+            {
+                // A failed attempt is the only time the adventurer can be boxed in by its own path
+                if (!hasUnvisitedNeighbor(walker.visited, walker.x, walker.y, n))
+                {
+                    retire(shard, walker);
+                    shard.walkers[w].reset();
+                }
+
+                continue;
+            }
+
+            walker.x = nx;
+            walker.y = ny;
+            walker.visited.insert(nx, ny);
+            walker.moves++;
+
+            if (!owns(t, nx))
+            {
+                walker.arriving = true;
+                shard.totals.migrations++;
+                send(t, std::move(shard.walkers[w]));
+
+                continue;
+            }
+
+            if (!applyCell(t, walker))
+            {
+                retire(shard, walker);
+                shard.walkers[w].reset();
+            }
+        }
+
+        shard.walkers.erase(std::remove(shard.walkers.begin(), shard.walkers.end(), nullptr), shard.walkers.end());
+    }
+
+    // Delivering every adventurer in flight, so each shard holds exactly the adventurers of its band.
+    // Called by all threads; rounds of receive / barrier repeat until no queue or backlog holds anything.
+    void settle(int t)
+    {
+        for (;;)
+        {
+            receive(t);
+
+            #pragma omp barrier
+
+            Shard& shard = *shards[t];
+
+            // Nobody pushes between the barriers, so the inboxes can be sized here
+            shard.pending = (long)(shard.backlogUp.size() + shard.backlogDown.size()) + shard.fromAbove.size() + shard.fromBelow.size();
+
+            #pragma omp barrier
+
+            long pending = 0;
+
+            for (const std::unique_ptr<Shard>& other : shards)
+                pending += other->pending;
+
+            if (pending == 0)
+                return;
+        }
+    }
+
+    // Run by one thread between barriers: deciding whether to stop, and moving the band boundaries if
+    // the adventurers are unevenly spread (the most loaded shard above 1.25x the average). Below
+    // MIN_REBALANCE adventurers per shard, the spread is noise and not worth migrations.
+    void endEpoch(int remainingTreasures)
+    {
+        const int count = (int)shards.size();
+
+        long live = 0, peak = 0;
+        int collected = 0;
+
+        for (const std::unique_ptr<Shard>& shard : shards)
+        {
+            live += shard->live;
+            peak = std::max(peak, shard->live);
+            collected += shard->collected;
+        }
+
+        result.epochs++;
+        rebalanced = false;
+        stopping = live == 0 || collected >= remainingTreasures;
+
+        if (stopping || count == 1 || live < MIN_REBALANCE * count)
+            return;
+
+        double imbalance = (double)peak * count / live;
+
+        result.peakImbalance = std::max(result.peakImbalance, imbalance);
+
+        if (imbalance <= 1.25)
+            return;
+
+        // Cutting the rows into bands of about live / count adventurers each (every row weighs at least 1,
+        // so empty stretches of the grid are still shared out)
+        long total = 0;
+
+        for (int r = 0; r < n; r++)
+            total += rowLoad[r] + 1;
+
+        long sum = 0;
+        int band = 1;
+
+        for (int r = 0; r < n && band < count; r++)
+        {
+            sum += rowLoad[r] + 1;
+
+            while (band < count && sum * count >= total * band)
+                bounds[band++] = r + 1;
+        }
+
+        while (band < count)
+            bounds[band++] = n;
+
+        rebalanced = true;
+        result.rebalances++;
+    }
+
+    // After a rebalance: sending away the adventurers outside shard t's new band.
+    void redistribute(int t)
+    {
+        Shard& shard = *shards[t];
+
+        for (std::unique_ptr<Walker>& walker : shard.walkers)
+        {
+            if (!owns(t, walker->x))
+            {
+                shard.totals.rebalanceMoves++;
+                send(t, std::move(walker));
+            }
+        }
+
+        shard.walkers.erase(std::remove(shard.walkers.begin(), shard.walkers.end(), nullptr), shard.walkers.end());
+    }
+};
@@ -0,0 +1,182 @@
+/********************************************************************
+ * File:        visitedSet.h
+ *
+ * Description: Per-adventurer set of visited cells, in two layouts:
+ *
+ *              - Dense: one bit per grid cell. Lookups are a single load,
+ *                but every adventurer pays N*N/8 bytes, which only suits
+ *                small grids.
+ *              - Sparse: 8x8 blocks of cells, each a 64-bit mask, stored in
+ *                an open-addressing hash table (linear probing, kept at
+ *                most half full). A walk touches few blocks, so the table
+ *                stays small (16 bytes per block in use, times the load
+ *                factor) whatever the grid size.
+ *
+ *              chooseVisitedKind() picks one from the grid size and the
+ *              expected path length. Lookups and probes are counted for
+ *              the end-of-run statistics.
+ ********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum VisitedKind { VISITED_AUTO, VISITED_DENSE, VISITED_SPARSE };
+
+inline const char* visitedKindName(VisitedKind kind)
+{
+    return kind == VISITED_DENSE ? "dense" : kind == VISITED_SPARSE ? "sparse" : "auto";
+}
+
+inline size_t denseVisitedBytes(int N)
+{
+    return ((size_t)N * N + 63) / 64 * sizeof(uint64_t);
+}
+
+// Dense when its bitmap is at most 4x the sparse table expected for a path of pathLength cells.
+// Blocks are assumed to hold 4 visited cells on average, and the table to be half full.
+inline VisitedKind chooseVisitedKind(int N, long pathLength)
+{
+    size_t blocks = (size_t)pathLength / 4 + 1;
+    size_t sparseBytes = 2 * blocks * 2 * sizeof(uint64_t);
+
+    return denseVisitedBytes(N) <= 4 * sparseBytes ? VISITED_DENSE : VISITED_SPARSE;
+}
+
+class VisitedSet
+{
+public:
+    // Emptying the set and switching it to kind for an N x N grid (kind must not be VISITED_AUTO).
+    void reset(VisitedKind setKind, int N)
+    {
+        kind = setKind;
+        n = N;
+        used = 0;
+        lookups = probes = 0;
+
+        if (kind == VISITED_DENSE)
+        {
+            bits.assign(denseVisitedBytes(N) / sizeof(uint64_t), 0);
+            blocks.clear();
+        }
+        else
+        {
+            bits.clear();
+            blocks.assign(16, Block());
+        }
+    }
+
+    bool contains(int x, int y) const
+    {
+        lookups++;
+
+        if (kind == VISITED_DENSE)
+        {
+            size_t index = (size_t)x * n + y;
+
+            probes++;
+
+            return (bits[index >> 6] >> (index & 63)) & 1;
+        }
+
+        const Block& block = blocks[findSlot(blockKey(x, y), probes)];
+
+        return block.key != EMPTY_KEY && ((block.mask >> blockBit(x, y)) & 1);
+    }
+
+    void insert(int x, int y)
+    {
+        if (kind == VISITED_DENSE)
+        {
+            size_t index = (size_t)x * n + y;
+
+            bits[index >> 6] |= (uint64_t)1 << (index & 63);
+
+            return;
+        }
+
+        uint64_t key = blockKey(x, y);
+        long steps = 0;
+        size_t slot = findSlot(key, steps);
+
+        if (blocks[slot].key == EMPTY_KEY)
+        {
+            if (2 * (used + 1) > blocks.size())
+            {
+                grow();
+                slot = findSlot(key, steps);
+            }
+
+            blocks[slot].key = key;
+            used++;
+        }
+
+        blocks[slot].mask |= (uint64_t)1 << blockBit(x, y);
+    }
+
+    size_t bytesUsed() const { return bits.capacity() * sizeof(uint64_t) + blocks.capacity() * sizeof(Block); }
+
+    VisitedKind getKind() const { return kind; }
+
+    long getLookups() const { return lookups; }
+    long getProbes() const { return probes; }  // Words / slots inspected by the lookups
+
+private:
+    static constexpr uint64_t EMPTY_KEY = ~(uint64_t)0;
+
+    VisitedKind kind = VISITED_DENSE;
+    int n = 0;
+
+    std::vector<uint64_t> bits;  // Dense: row-major, one bit per cell
+
+    // Sparse: one table entry per 8x8 block in use, key and mask side by side so a probe touches one line
+    struct Block
+    {
+        uint64_t key = EMPTY_KEY;  // Block coordinates (bx << 32 | by)
+        uint64_t mask = 0;         // Visited cells of the block, bit (x % 8) * 8 + y % 8
+    };
+
+    std::vector<Block> blocks;
+    size_t used = 0;
+
+    mutable long lookups = 0;
+    mutable long probes = 0;  // Only lookups (contains) are counted, not inserts or rehashing
+
+    static uint64_t blockKey(int x, int y) { return (uint64_t)(uint32_t)(x >> 3) << 32 | (uint32_t)(y >> 3); }
+    static int blockBit(int x, int y) { return (x & 7) * 8 + (y & 7); }
+
+    // Slot holding key, or the free slot where it would go; adds the slots inspected to steps.
+    size_t findSlot(uint64_t key, long& steps) const
+    {
+        const size_t mask = blocks.size() - 1;
+        size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+
+        for (;;)
+        {
+            steps++;
+
+            if (blocks[slot].key == key || blocks[slot].key == EMPTY_KEY)
+                return slot;
+
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    void grow()
+    {
+        std::vector<Block> old;
+
+        old.swap(blocks);
+        blocks.assign(old.size() * 2, Block());
+
+        long steps = 0;
+
+        for (const Block& block : old)
+        {
+            if (block.key != EMPTY_KEY)
+                blocks[findSlot(block.key, steps)] = block;
+        }
+    }
+};